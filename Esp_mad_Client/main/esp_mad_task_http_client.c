@@ -21,11 +21,13 @@
 #include <sys/param.h>
 #include <freertos/event_groups.h>
 #include <esp_http_client.h>
+#include <esp_pm.h>
 #include <string.h>
 #include <stdlib.h>
-#include <cJSON.h>
 #include <Esp_mad.h>
 #include <Esp_mad_Globals_Variables.h>
+#include "esp_mad_format.h"
+#include "esp_mad_json.h"
 
 /* FreeRTOS event group to signal when we are connected & ready to make a request */
 
@@ -137,6 +139,11 @@ static void initialise_wifi(void *arg)
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+
+#if CONFIG_PM_ENABLE
+    /*--- Modem sleep between the DTIM beacons of the server, required by light sleep in station mode ---*/
+    ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_MIN_MODEM));
+#endif
 } /* end initialise wifi */
 
 /**
@@ -220,11 +227,11 @@ esp_err_t _http_event_handler(esp_http_client_event_t *evt)
 void task_http_client(void *ignore)
 
 {
-    char post_data[30];
+    char post_data[96];
 
     static const char tag[] = "http_client->";
 
-    float voltage2;
+    fmt_buf_t json;
 
     EventBits_t uxBits;
 
@@ -236,36 +243,51 @@ void task_http_client(void *ignore)
 
     };
 
-    /*--- Initialize nvs partition ---*/
-    esp_err_t ret = nvs_flash_init();
-    
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+    /*--- nvs partition initialized by app_main() ---*/
 
-      ESP_ERROR_CHECK(nvs_flash_erase());
+    initialise_wifi(NULL);
 
-      ret = nvs_flash_init();
+#if CONFIG_PM_ENABLE
+    /*--- Full clock and no light sleep while a /sensor2 request is built, sent and answered ---*/
+    esp_pm_lock_handle_t pmLock = NULL;
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "http_client", &pmLock) != ESP_OK)
+    {
+        ESP_LOGW(tag, "http_client PM lock not created");
     }
-
-    ESP_ERROR_CHECK(ret);
-
-    initialise_wifi(NULL);
+#endif
 
 	while(1)
 	{
 
     uxBits = xEventGroupWaitBits(wifi_event_group, CONNECTED_BIT, false, true, portMAX_DELAY);    
 
-    voltage2 = g_voltage/1000.0;
-
-    ESP_LOGI(tag, "voltage2 %f - voltage %d\n", voltage2, g_voltage);
+    ESP_LOGI(tag, "voltage %d mV\n", (int)g_voltage);
 
     /*--- if station connected and MPU calibration done ---*/
-    if(((uxBits & CONNECTED_BIT) != 0) && BInit)
+    if(((uxBits & CONNECTED_BIT) != 0) && g_calibrationState != CALIBRATION_BOOT)
+        {
+
+#if CONFIG_PM_ENABLE
+        if (pmLock != NULL)
         {
+            esp_pm_lock_acquire(pmLock);
+        }
+#endif
 
         esp_http_client_handle_t client = esp_http_client_init(&config);
 
-        sprintf(post_data,"{\"angle\":%0.1f,\"voltage\":%0.2f}", g_angle, voltage2);
+        /*--- Scaled integers rendered by esp_mad_format (0.1 degree, 0.01 V), no printf float ---*/
+        fmt_init(&json, post_data, sizeof(post_data));
+        fmt_char(&json, '{');
+        fmt_key(&json, "angle");
+        fmt_fixed(&json, fmt_scale(g_angleSettled, 1), 1);
+        fmt_key(&json, "voltage");
+        fmt_fixed(&json, ((int32_t)g_voltage + 5) / 10, 2);
+        fmt_key(&json, "soc");
+        fmt_int(&json, g_batterySoc);
+        fmt_key(&json, "runtime_min");
+        fmt_int(&json, g_batteryRuntimeMin);
+        fmt_char(&json, '}');
 
         esp_http_client_set_url(client, "http://192.168.1.1/sensor2");
 
@@ -294,26 +316,33 @@ void task_http_client(void *ignore)
 
                 if (read_len >= 0)
                 {
-                    cJSON *resp_json = cJSON_Parse(response_buf);
-                    if (resp_json)
+                    json_tok_t tokens[JSON_SMALL_TOKENS];
+                    json_doc_t resp_json;
+                    if (json_doc_parse(&resp_json, response_buf, read_len, tokens, JSON_SMALL_TOKENS) > 0)
                     {
-                        const cJSON *target_angle_json = cJSON_GetObjectItemCaseSensitive(resp_json, "targetAngle");
-                        if (cJSON_IsNumber(target_angle_json))
+                        float targetAngle;
+                        if (json_get_float(&resp_json, "targetAngle", &targetAngle))
                         {
-                            g_targetAngle = target_angle_json->valuedouble;
+                            g_targetAngle = targetAngle;
                         }
 
-                        const cJSON *target_active_json = cJSON_GetObjectItemCaseSensitive(resp_json, "targetActive");
-                        if (cJSON_IsBool(target_active_json))
+                        bool targetActive;
+                        int32_t targetActiveInt;
+                        if (json_get_bool(&resp_json, "targetActive", &targetActive))
                         {
-                            g_targetAngleActive = cJSON_IsTrue(target_active_json);
+                            g_targetAngleActive = targetActive;
                         }
-                        else if (cJSON_IsNumber(target_active_json))
+                        else if (json_get_int(&resp_json, "targetActive", &targetActiveInt))
                         {
-                            g_targetAngleActive = target_active_json->valuedouble > 0.5;
+                            g_targetAngleActive = targetActiveInt > 0;
                         }
 
-                        cJSON_Delete(resp_json);
+                        /*--- /reset hinge=relearn on the server : this sensor moved as well ---*/
+                        int32_t relearn;
+                        if (json_get_int(&resp_json, "relearnHinge", &relearn) && relearn > 0)
+                        {
+                            MEASURE_REQUEST(MEASURE_REQUEST_HINGE);
+                        }
                     }
                 }
             }
@@ -325,6 +354,12 @@ void task_http_client(void *ignore)
 
         esp_http_client_cleanup(client);
 
+#if CONFIG_PM_ENABLE
+        if (pmLock != NULL)
+        {
+            esp_pm_lock_release(pmLock);
+        }
+#endif
 
         } /* end if uxBits*/  
 
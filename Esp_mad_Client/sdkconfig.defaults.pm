@@ -0,0 +1,13 @@
+## Power managed build profile, on top of sdkconfig.defaults :
+##   idf.py -D SDKCONFIG_DEFAULTS="sdkconfig.defaults;sdkconfig.defaults.pm" build
+
+# Dynamic frequency scaling, configured by power_management_init() in esp_mad_client.cpp.
+CONFIG_PM_ENABLE=y
+
+# Tickless idle : automatic light sleep when no task is ready and no PM lock is held.
+CONFIG_FREERTOS_USE_TICKLESS_IDLE=y
+CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP=3
+
+# WiFi station : modem sleep between the DTIM beacons (esp_wifi_set_ps() in esp_mad_task_http_client.c),
+# WiFi sleep code in IRAM so the radio wakes up in time from light sleep.
+CONFIG_ESP_WIFI_SLP_IRAM_OPT=y
@@ -33,6 +33,9 @@
 #include <esp_log.h>
 #include <esp_system.h>
 #include <esp_http_server.h>
+#include <esp_pm.h>
+#include <esp_rom_sys.h>
+#include <esp_timer.h>
 #include <math.h>
 #include <nvs_flash.h>
 #include <sys/param.h>
@@ -40,6 +43,8 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/event_groups.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "lwip/err.h"
@@ -48,8 +53,16 @@
 #include "esp_mac.h"
 #include <Esp_mad.h>
 #include <Esp_mad_Globals_Variables.h>
+#include "esp_mad_profile.h"
+#include "esp_mad_sweep.h"
+#include "esp_mad_jitter.h"
+#include "esp_mad_accel_calib.h"
+#include "esp_mad_format.h"
+#include "esp_mad_json.h"
+#include "esp_mad_form.h"
 
 #define SENSOR_JSON_BUF_SIZE 512
+#define POST_BODY_MAX_SIZE 96        /* largest request body accepted, /sensor2 from the client */
 
 /*-----------------------------------------
  *-            LOCALS VARIABLES
@@ -57,7 +70,10 @@
 float travel2 = 0.0;
 float angle2 = 0.0;
 
-float voltage2 = 0.0;
+int voltage2Mv = 0;
+int soc2 = -1;
+int runtime2 = -1;
+bool hingeRelearn2 = false;      /* hinge relearn to pass to the client in the next /sensor2 answer */
 
 extern const uint8_t esp_html_start[] asm("_binary_esp_html_start");
 extern const uint8_t esp_html_end[] asm("_binary_esp_html_end");
@@ -215,8 +231,6 @@ esp_err_t sensors_get_handler(httpd_req_t *req)
     char *host_header = NULL;
     size_t buf_len;
 
-    float voltage1 = 0.0;
-
     float relativeTravel1;
     float relativeTravel2;
     float relativeAngle1;
@@ -250,10 +264,18 @@ esp_err_t sensors_get_handler(httpd_req_t *req)
 
     memset(buf, 0, sizeof(buf));
 
-    /*--- Compute Min, Max and Deltas for both sensors ---*/
-    relativeTravel1 = g_travel - g_travelZeroOffset;
+    /*--- A second MPU6050 on this board replaces the client board ---*/
+    if (g_sensorCount > 1)
+    {
+        angle2 = g_angleSensor2;
+        travel2 = g_travelSensor2;
+    }
+
+    /*--- Compute Min, Max and Deltas for both sensors. Settled readings (window mean) once ---*/
+    /*--- the surface is steady, so the display does not flicker in the 0.1 degree digit.   ---*/
+    relativeTravel1 = g_travelSettled - g_travelZeroOffset;
     relativeTravel2 = travel2 - g_travel2ZeroOffset;
-    relativeAngle1 = g_angle - g_angleZeroOffset;
+    relativeAngle1 = g_angleSettled - g_angleZeroOffset;
     relativeAngle2 = angle2 - g_angle2ZeroOffset;
 
     if (targetEnabled)
@@ -261,26 +283,51 @@ esp_err_t sensors_get_handler(httpd_req_t *req)
         targetDiff = fabsf(relativeAngle1 - g_targetAngle);
     }
 
-    /*--- compute voltage in volt ---*/
-    voltage1 = g_voltage / 1000.0;
-
-    ESP_LOGI(TAG, "voltage1 %f - voltage2 %f", voltage1, voltage2);
-
-    /*--- Preparing the buffer request in json format ---*/
-    int len = snprintf(buf, SENSOR_JSON_BUF_SIZE, "{\"travel1\":%0.1f,\"travel2\":%0.1f,\"angle1\":%0.1f,\"angle2\":%0.1f,\"voltage1\":%0.2f, \"voltage2\":%0.2f,\"targetAngle\":%0.2f,\"targetDiff\":%0.2f,\"targetEnabled\":%d}",
-                       relativeTravel1,
-                       relativeTravel2,
-                       relativeAngle1,
-                       relativeAngle2,
-                       voltage1,
-                       voltage2,
-                       g_targetAngle,
-                       targetDiff,
-                       targetEnabled ? 1 : 0);
-
-    if (len < 0 || len >= SENSOR_JSON_BUF_SIZE)
+    ESP_LOGI(TAG, "voltage1 %d mV - voltage2 %d mV", (int)g_voltage, voltage2Mv);
+
+    /*--- Preparing the buffer request in json format : scaled integers (0.1 mm, 0.1 and 0.01 ---*/
+    /*--- degree, 0.01 V) rendered by esp_mad_format, no printf float formatting.            ---*/
+    fmt_buf_t json;
+    fmt_init(&json, buf, SENSOR_JSON_BUF_SIZE);
+    fmt_char(&json, '{');
+    fmt_key(&json, "travel1");
+    fmt_fixed(&json, fmt_scale(relativeTravel1, 1), 1);
+    fmt_key(&json, "travel2");
+    fmt_fixed(&json, fmt_scale(relativeTravel2, 1), 1);
+    fmt_key(&json, "angle1");
+    fmt_fixed(&json, fmt_scale(relativeAngle1, 1), 1);
+    fmt_key(&json, "angle2");
+    fmt_fixed(&json, fmt_scale(relativeAngle2, 1), 1);
+    fmt_key(&json, "voltage1");
+    fmt_fixed(&json, ((int32_t)g_voltage + 5) / 10, 2);
+    fmt_key(&json, "voltage2");
+    fmt_fixed(&json, (voltage2Mv + 5) / 10, 2);
+    fmt_key(&json, "soc1");
+    fmt_int(&json, g_batterySoc);
+    fmt_key(&json, "soc2");
+    fmt_int(&json, soc2);
+    fmt_key(&json, "runtime1");
+    fmt_int(&json, g_batteryRuntimeMin);
+    fmt_key(&json, "runtime2");
+    fmt_int(&json, runtime2);
+    fmt_key(&json, "lowBattery");
+    fmt_int(&json, g_lowBattery ? 1 : 0);
+    fmt_key(&json, "targetAngle");
+    fmt_fixed(&json, fmt_scale(g_targetAngle, 2), 2);
+    fmt_key(&json, "targetDiff");
+    fmt_fixed(&json, fmt_scale(targetDiff, 2), 2);
+    fmt_key(&json, "targetEnabled");
+    fmt_int(&json, targetEnabled ? 1 : 0);
+    fmt_key(&json, "settled");
+    fmt_int(&json, g_settled ? 1 : 0);
+    fmt_key(&json, "confidence");
+    fmt_fixed(&json, fmt_scale(g_angleConfidence, 2), 2);
+    fmt_char(&json, '}');
+    int len = fmt_end(&json);
+
+    if (len < 0)
     {
-        ESP_LOGE(TAG, "Sensor JSON truncated (len=%d)", len);
+        ESP_LOGE(TAG, "Sensor JSON truncated");
         httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON truncated");
         return ESP_FAIL;
     }
@@ -289,226 +336,982 @@ esp_err_t sensors_get_handler(httpd_req_t *req)
 
     ESP_LOGI(TAG, "json = %s\n", buf);
 
+    /*--- ETag of the reading : while it does not change, the UI gets an empty 304 ---*/
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < len; i++)
+    {
+        hash = (hash ^ (uint8_t)buf[i]) * 16777619u;
+    }
+    char etag[12];
+    char if_none_match[12];
+    snprintf(etag, sizeof(etag), "\"%08" PRIx32 "\"", hash);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "ETag", etag);
+
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", if_none_match, sizeof(if_none_match)) == ESP_OK &&
+        strcmp(if_none_match, etag) == 0)
+    {
+        httpd_resp_set_status(req, "304 Not Modified");
+        httpd_resp_send(req, NULL, 0);
+        return ESP_OK;
+    }
+
+    /*--- Send the request ---*/
+    httpd_resp_send(req, buf, len);
+
+    ESP_LOGI(TAG, "Exit    ----> sensor_get_handler()\n");
+
+    return ESP_OK;
+
+} /* end sensors_get_handler() */
+
+httpd_uri_t sensors = {
+
+    .uri = "/sensors",
+
+    .method = HTTP_GET,
+
+    .handler = sensors_get_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    static int body_read(httpd_req_t *req, char *buf, size_t size)
+ *	@brief 		Receives the whole request body in buf, however many receives it takes. Every POST
+ *	            handler reads its body with it, in a POST_BODY_MAX_SIZE buffer on its stack. The error
+ *	            response is sent on failure.
+ *	@param[in]	req : httpd request, buf / size : destination
+ *	@return		body length, -1 on failure
+ */
+static int body_read(httpd_req_t *req, char *buf, size_t size)
+{
+    int ret;
+    int remaining = req->content_len;
+    int offset = 0;
+
+    if (remaining > (int)size)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Payload too large");
+        return -1;
+    }
+
+    while (remaining > 0)
+    {
+        ret = httpd_req_recv(req, buf + offset, remaining);
+        if (ret <= 0)
+        {
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT)
+            {
+                continue;
+            }
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to receive body");
+            return -1;
+        }
+        remaining -= ret;
+        offset += ret;
+    }
+
+    return offset;
+}
+
+/**
+ *	@fn 	    static bool body_json(httpd_req_t *req, json_doc_t *doc, char *buf, size_t size, json_tok_t *tokens, int max)
+ *	@brief 		Receives the whole request body and tokenizes it in one pass, the tokens in the
+ *	            caller's array (no heap). The error response is sent on failure.
+ *	@param[in]	req : httpd request, doc : parsed body, buf / size : body buffer, tokens / max : token array
+ *	@return		true if the body is a JSON object
+ */
+static bool body_json(httpd_req_t *req, json_doc_t *doc, char *buf, size_t size, json_tok_t *tokens, int max)
+{
+    int len = body_read(req, buf, size);
+
+    if (len < 0)
+    {
+        return false;
+    }
+
+    if (json_doc_parse(doc, buf, len, tokens, max) < 0)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ *	@fn 	    static bool body_form(httpd_req_t *req, form_t *form, char *buf, size_t size)
+ *	@brief 		Receives the whole request body, application/x-www-form-urlencoded, or takes the query
+ *	            string of the uri when the body is empty. Nothing is copied, the form points to buf or
+ *	            to req->uri. The error response is sent on failure.
+ *	@param[in]	req : httpd request, form : decoder, buf / size : body buffer
+ *	@return		true if the body was received
+ */
+static bool body_form(httpd_req_t *req, form_t *form, char *buf, size_t size)
+{
+    int len = body_read(req, buf, size);
+
+    if (len < 0)
+    {
+        return false;
+    }
+
+    if (len > 0)
+    {
+        form_init(form, buf, len);
+    }
+    else
+    {
+        form_init_query(form, req->uri);
+    }
+
+    return true;
+}
+
+/**
+ *	@fn 	    esp_err_t chord_post_handler (httpd_req_t *req)
+ *	@brief 		An HTTP POST handler.
+ *	@param[in]	*req : un http_req_t pointer.
+ *	@return
+ *      - ESP_OK
+ *      - ESP_FAIL
+ */
+esp_err_t sensor2_post_handler(httpd_req_t *req)
+{
+
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
+    float voltage;
+    int32_t value;
+
+    ESP_LOGI(TAG, "Entering ----> sensor2_post_handler()\n");
+    ESP_LOGI(TAG, "method: %d\n", req->method);
+    ESP_LOGI(TAG, "uri: %s\n", req->uri);
+
+    /*--- Whole body, then one pass of the tokenizer ---*/
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
+    {
+        return ESP_FAIL;
+    }
+
+    /* Log data received */
+
+    ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
+
+    ESP_LOGI(TAG, "%.*s", req->content_len, buf);
+
+    ESP_LOGI(TAG, "====================================");
+
+    if (!json_get_float(&doc, "angle", &angle2))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "angle missing");
+        return ESP_FAIL;
+    }
+    voltage2Mv = json_get_float(&doc, "voltage", &voltage) ? (int)(voltage * 1000.0f + 0.5f) : 0;
+    soc2 = json_get_int(&doc, "soc", &value) ? (int)value : -1;
+    runtime2 = json_get_int(&doc, "runtime_min", &value) ? (int)value : -1;
+
+    /*--- Compute travel2 ---*/
+    travel2 = g_chordControlSurface * sin((angle2 * (2.0 * PI) / 360.0) / 2.0) * 2.0;
+
+    ESP_LOGI(TAG, "angle2 : %d - travel2 : %d (0.1) - voltage2 : %d mV\n", (int)fmt_scale(angle2, 1), (int)fmt_scale(travel2, 1), voltage2Mv);
+
+    ESP_LOGI(TAG, "Exit ----> sensor2_post_handler()\n");
+
+    char response[96];
+    fmt_buf_t json;
+    fmt_init(&json, response, sizeof(response));
+    fmt_char(&json, '{');
+    fmt_key(&json, "targetAngle");
+    fmt_fixed(&json, fmt_scale(g_targetAngle, 2), 2);
+    fmt_key(&json, "targetActive");
+    fmt_int(&json, g_targetAngleActive ? 1 : 0);
+    if (hingeRelearn2)
+    {
+        fmt_key(&json, "relearnHinge");
+        fmt_int(&json, 1);
+        hingeRelearn2 = false;
+    }
+    fmt_char(&json, '}');
+    int resp_len = fmt_end(&json);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, response, resp_len);
+
+    return ESP_OK;
+
+} /* end sensor2_post_handler() */
+
+httpd_uri_t sensor2 = {
+
+    .uri = "/sensor2",
+
+    .method = HTTP_POST,
+
+    .handler = sensor2_post_handler,
+
+    .user_ctx = NULL
+
+};
+
+esp_err_t target_angle_post_handler(httpd_req_t *req)
+{
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
+
+    ESP_LOGI(TAG, "Entering ----> target_angle_post_handler()\n");
+
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
+    {
+        return ESP_FAIL;
+    }
+
+    float targetAngle;
+    if (!json_get_float(&doc, "targetAngle", &targetAngle))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "targetAngle missing");
+        return ESP_FAIL;
+    }
+
+    g_targetAngle = targetAngle;
+    g_targetAngleActive = true;
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+
+    ESP_LOGI(TAG, "Exit ----> target_angle_post_handler()\n");
+
+    return ESP_OK;
+}
+
+httpd_uri_t target_angle_uri = {
+
+    .uri = "/target_angle",
+
+    .method = HTTP_POST,
+
+    .handler = target_angle_post_handler,
+
+    .user_ctx = NULL
+
+};
+
+esp_err_t reset_post_handler(httpd_req_t *req)
+{
+    char buf[POST_BODY_MAX_SIZE];
+    form_t form;
+    bool relearn = false;
+
+    ESP_LOGI(TAG, "Entering ----> reset_post_handler()\n");
+
+    /*--- Optional hinge=relearn : sensors moved to other surfaces, hinge axes learnt again ---*/
+    if (!body_form(req, &form, buf, sizeof(buf)))
+    {
+        return ESP_FAIL;
+    }
+    const char *value;
+    size_t len;
+    if (form_find(&form, "hinge", &value, &len))
+    {
+        char hinge[12];
+        if (!form_get_string(&form, "hinge", hinge, sizeof(hinge)) || strcmp(hinge, "relearn") != 0)
+        {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "hinge must be relearn");
+            return ESP_FAIL;
+        }
+        relearn = true;
+    }
+
+#if ESP_MAD_ATTITUDE_3D
+    if (relearn)
+    {
+        MEASURE_REQUEST(MEASURE_REQUEST_HINGE);
+        hingeRelearn2 = true;
+    }
+    /*--- The measure task takes the current orientation as reference, angle and travel restart from 0 ---*/
+    MEASURE_REQUEST(MEASURE_REQUEST_REFERENCE);
+    g_travelZeroOffset = 0.0;
+    g_angleZeroOffset = 0.0;
+#else
+    g_travelZeroOffset = g_travel;
+    g_angleZeroOffset = g_angle;
+#endif
+    if (g_sensorCount > 1)
+    {
+        /*--- Second MPU6050 of this board ---*/
+#if ESP_MAD_ATTITUDE_3D
+        g_travel2ZeroOffset = 0.0;
+        g_angle2ZeroOffset = 0.0;
+#else
+        g_travel2ZeroOffset = g_travelSensor2;
+        g_angle2ZeroOffset = g_angleSensor2;
+#endif
+    }
+    else
+    {
+        g_travel2ZeroOffset = travel2;
+        g_angle2ZeroOffset = angle2;
+    }
+
+    const char *resp = "{\"status\":\"ok\"}";
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, resp, strlen(resp));
+
+    ESP_LOGI(TAG, "Exit ----> reset_post_handler()\n");
+
+    return ESP_OK;
+}
+
+httpd_uri_t reset_uri = {
+
+    .uri = "/reset",
+
+    .method = HTTP_POST,
+
+    .handler = reset_post_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t profile_get_handler(httpd_req_t *req)
+ *	@brief 		Acquisition profile in use and the available ones
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t profile_get_handler(httpd_req_t *req)
+{
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
+    const acquisition_profile_t *current = acquisition_profile_get(g_acquisitionProfile);
+    cJSON_AddStringToObject(root, "profile", current->name);
+    cJSON_AddBoolToObject(root, "idle", g_idle);
+    cJSON_AddNumberToObject(root, "idle_timeout_s", g_idleTimeoutS);
+    cJSON_AddNumberToObject(root, "low_battery_soc", g_lowBatterySoc);
+    cJSON_AddBoolToObject(root, "low_battery", g_lowBattery);
+
+    cJSON *list = cJSON_AddArrayToObject(root, "profiles");
+    for (int i = 0; list != NULL && i < acquisition_profile_count(); i++)
+    {
+        const acquisition_profile_t *profile = acquisition_profile_get(i);
+        cJSON *item = cJSON_CreateObject();
+        if (item == NULL)
+        {
+            continue;
+        }
+        cJSON_AddStringToObject(item, "name", profile->name);
+        cJSON_AddNumberToObject(item, "odr_hz", 1000 / (1 + profile->rateDiv));
+        cJSON_AddNumberToObject(item, "dlpf", profile->dlpfMode);
+        cJSON_AddNumberToObject(item, "gyro_dps", 250 << profile->gyroRange);
+        cJSON_AddNumberToObject(item, "accel_g", 2 << profile->accelRange);
+        cJSON_AddNumberToObject(item, "loop_ms", profile->loopPeriodMs);
+        cJSON_AddItemToArray(list, item);
+    }
+
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_sendstr(req, json);
+    cJSON_free(json);
+
+    return ESP_OK;
+}
+
+httpd_uri_t profile_get_uri = {
+
+    .uri = "/profile",
+
+    .method = HTTP_GET,
+
+    .handler = profile_get_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t profile_post_handler(httpd_req_t *req)
+ *	@brief 		Select an acquisition profile, the idle timeout and/or the low battery threshold, body
+ *	            {"profile":"<name>","idle_timeout_s":60,"low_battery_soc":20}, all optional. The
+ *	            profile is applied and saved by the measure task at its next cycle; 0 s disables the
+ *	            idle mode, 0 % the low battery switch to the low_power profile.
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t profile_post_handler(httpd_req_t *req)
+{
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
+
+    ESP_LOGI(TAG, "Entering ----> profile_post_handler()\n");
+
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
+    {
+        return ESP_FAIL;
+    }
+
+    char name[24];
+    int32_t timeoutS = 0;
+    int32_t lowSocPercent = 0;
+    bool hasName = json_find(&doc, "profile") >= 0;
+    bool hasTimeout = json_find(&doc, "idle_timeout_s") >= 0;
+    bool hasLowSoc = json_find(&doc, "low_battery_soc") >= 0;
+    int index = json_get_string(&doc, "profile", name, sizeof(name)) ? acquisition_profile_find(name) : -1;
+    bool timeoutValid = json_get_int(&doc, "idle_timeout_s", &timeoutS) && timeoutS >= 0 && timeoutS <= UINT16_MAX;
+    bool lowSocValid = json_get_int(&doc, "low_battery_soc", &lowSocPercent) && lowSocPercent >= 0 && lowSocPercent <= 100;
+
+    if ((hasName && index < 0) || (hasTimeout && !timeoutValid) || (hasLowSoc && !lowSocValid) ||
+        (!hasName && !hasTimeout && !hasLowSoc))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, hasName && index < 0 ? "Unknown profile" :
+                            hasLowSoc && !lowSocValid ? "Invalid low_battery_soc" : "Invalid idle_timeout_s");
+        return ESP_FAIL;
+    }
+
+    if (hasLowSoc)
+    {
+        g_lowBatterySoc = (uint8_t)lowSocPercent;
+    }
+
+    if (hasTimeout)
+    {
+        g_idleTimeoutS = (uint16_t)timeoutS;
+    }
+    if (index >= 0)
+    {
+        g_profileRequest = index;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+
+    ESP_LOGI(TAG, "Exit ----> profile_post_handler()\n");
+
+    return ESP_OK;
+}
+
+httpd_uri_t profile_post_uri = {
+
+    .uri = "/profile",
+
+    .method = HTTP_POST,
+
+    .handler = profile_post_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t sweep_get_handler(httpd_req_t *req)
+ *	@brief 		State of the servo sweep capture, metrics and decimated trace of the last one
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t sweep_get_handler(httpd_req_t *req)
+{
+    static const char *states[] = {"idle", "armed", "recording", "done"};
+    static float trace[SWEEP_TRACE_POINTS];
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
+    cJSON_AddStringToObject(root, "state", states[sweep_state()]);
+
+    sweep_result_t result;
+    if (sweep_result(&result))
+    {
+        cJSON_AddNumberToObject(root, "samples", result.samples);
+        cJSON_AddNumberToObject(root, "sample_ms", result.sampleMs);
+        cJSON_AddNumberToObject(root, "step_deg", result.stepDeg);
+        cJSON_AddNumberToObject(root, "peak_speed_dps", result.peakSpeedDps);
+        cJSON_AddNumberToObject(root, "t90_ms", result.t90Ms);
+        cJSON_AddNumberToObject(root, "overshoot_deg", result.overshootDeg);
+        cJSON_AddNumberToObject(root, "overshoot_percent", result.overshootPercent);
+        cJSON_AddNumberToObject(root, "settling_ms", result.settlingMs);
+
+        float step_ms = 0.0f;
+        int points = sweep_trace(trace, SWEEP_TRACE_POINTS, &step_ms);
+        cJSON_AddNumberToObject(root, "trace_step_ms", step_ms);
+        cJSON_AddItemToObject(root, "trace_deg", cJSON_CreateFloatArray(trace, points));
+    }
+
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_sendstr(req, json);
+    cJSON_free(json);
+
+    return ESP_OK;
+}
+
+httpd_uri_t sweep_get_uri = {
+
+    .uri = "/sweep",
+
+    .method = HTTP_GET,
+
+    .handler = sweep_get_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t sweep_post_handler(httpd_req_t *req)
+ *	@brief 		Arm the servo sweep capture, body {"arm":true}, or cancel it with {"arm":false}
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t sweep_post_handler(httpd_req_t *req)
+{
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
+
+    ESP_LOGI(TAG, "Entering ----> sweep_post_handler()\n");
+
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
+    {
+        return ESP_FAIL;
+    }
+
+    bool armed;
+    if (!json_get_bool(&doc, "arm", &armed))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "arm missing");
+        return ESP_FAIL;
+    }
+
+    sweep_arm(armed);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+
+    ESP_LOGI(TAG, "Exit ----> sweep_post_handler()\n");
+
+    return ESP_OK;
+}
+
+httpd_uri_t sweep_post_uri = {
+
+    .uri = "/sweep",
+
+    .method = HTTP_POST,
+
+    .handler = sweep_post_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t jitter_get_handler(httpd_req_t *req)
+ *	@brief 		Results of the jitter / flutter analysis since its start
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t jitter_get_handler(httpd_req_t *req)
+{
+    static const int band_hz[JITTER_BANDS + 1] = JITTER_BAND_HZ;
+    jitter_result_t result;
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
+    jitter_result(&result);
+    cJSON_AddBoolToObject(root, "running", jitter_requested());
+    cJSON_AddNumberToObject(root, "blocks", result.blocks);
+    cJSON_AddNumberToObject(root, "overruns", result.overruns);
+    cJSON_AddNumberToObject(root, "fifo_overflows", result.fifoOverflows);
+    cJSON_AddNumberToObject(root, "resolution_hz", (double)JITTER_SAMPLE_HZ / JITTER_FFT_SIZE);
+    cJSON_AddNumberToObject(root, "rms_dps", result.rmsDps);
+
+    cJSON *bands = cJSON_AddArrayToObject(root, "bands");
+    for (int i = 0; bands != NULL && i < JITTER_BANDS; i++)
+    {
+        cJSON *band = cJSON_CreateObject();
+        if (band == NULL)
+        {
+            continue;
+        }
+        cJSON_AddNumberToObject(band, "from_hz", band_hz[i]);
+        cJSON_AddNumberToObject(band, "to_hz", band_hz[i + 1]);
+        cJSON_AddNumberToObject(band, "rms_dps", result.bandRmsDps[i]);
+        cJSON_AddItemToArray(bands, band);
+    }
+
+    cJSON *peaks = cJSON_AddArrayToObject(root, "peaks");
+    for (int i = 0; peaks != NULL && i < JITTER_PEAKS && result.peaks[i].amplitudeDps > 0.0f; i++)
+    {
+        cJSON *peak = cJSON_CreateObject();
+        if (peak == NULL)
+        {
+            continue;
+        }
+        cJSON_AddNumberToObject(peak, "hz", result.peaks[i].frequencyHz);
+        cJSON_AddNumberToObject(peak, "amplitude_dps", result.peaks[i].amplitudeDps);
+        cJSON_AddItemToArray(peaks, peak);
+    }
+
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
+
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Cache-Control", "no-store");
-
-    /*--- Send the request ---*/
-    httpd_resp_send(req, buf, len);
-
-    ESP_LOGI(TAG, "Exit    ----> sensor_get_handler()\n");
+    httpd_resp_sendstr(req, json);
+    cJSON_free(json);
 
     return ESP_OK;
+}
 
-} /* end sensors_get_handler() */
-
-httpd_uri_t sensors = {
+httpd_uri_t jitter_get_uri = {
 
-    .uri = "/sensors",
+    .uri = "/jitter",
 
     .method = HTTP_GET,
 
-    .handler = sensors_get_handler,
+    .handler = jitter_get_handler,
 
     .user_ctx = NULL
 
 };
 
 /**
- *	@fn 	    esp_err_t chord_post_handler (httpd_req_t *req)
- *	@brief 		An HTTP POST handler.
- *	@param[in]	*req : un http_req_t pointer.
- *	@return
- *      - ESP_OK
- *      - ESP_FAIL
+ *	@fn 	    esp_err_t jitter_post_handler(httpd_req_t *req)
+ *	@brief 		Start the jitter analysis, body {"run":true}, or stop it with {"run":false}
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
  */
-esp_err_t sensor2_post_handler(httpd_req_t *req)
+esp_err_t jitter_post_handler(httpd_req_t *req)
 {
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
 
-    char buf[40];
-
-    int ret, remaining = req->content_len;
-    cJSON *sensor2_json = NULL;
-    const cJSON *json_angle = NULL;
-    const cJSON *json_voltage = NULL;
-
-    ESP_LOGI(TAG, "Entering ----> sensor2_post_handler()\n");
-    ESP_LOGI(TAG, "method: %d\n", req->method);
-    ESP_LOGI(TAG, "uri: %s\n", req->uri);
-
-    memset(buf, 0, sizeof(buf) - 1);
+    ESP_LOGI(TAG, "Entering ----> jitter_post_handler()\n");
 
-    while (remaining > 0)
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
     {
+        return ESP_FAIL;
+    }
 
-        /* Read the data for the request */
+    bool running;
+    if (!json_get_bool(&doc, "run", &running))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "run missing");
+        return ESP_FAIL;
+    }
 
-        if ((ret = httpd_req_recv(req, buf,
+    jitter_run(running);
 
-                                  MIN(remaining, sizeof(buf)))) <= 0)
-        {
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
 
-            if (ret == HTTPD_SOCK_ERR_TIMEOUT)
-            {
+    ESP_LOGI(TAG, "Exit ----> jitter_post_handler()\n");
 
-                /* Retry receiving if timeout occurred */
+    return ESP_OK;
+}
 
-                continue;
-            }
+httpd_uri_t jitter_post_uri = {
 
-            return ESP_FAIL;
-        }
+    .uri = "/jitter",
 
-        /* Log data received */
+    .method = HTTP_POST,
 
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
+    .handler = jitter_post_handler,
 
-        ESP_LOGI(TAG, "%.*s", ret, buf);
+    .user_ctx = NULL
 
-        ESP_LOGI(TAG, "====================================");
+};
 
-        /*--- Parse Json buffer received form client ---*/
-        sensor2_json = cJSON_Parse(buf);
-        json_angle = cJSON_GetObjectItemCaseSensitive(sensor2_json, "angle");
-        angle2 = json_angle->valuedouble;
-        json_voltage = cJSON_GetObjectItemCaseSensitive(sensor2_json, "voltage");
-        voltage2 = json_voltage->valuedouble;
-        cJSON_Delete(sensor2_json);
+/**
+ *	@fn 	    esp_err_t accel_calibration_get_handler(httpd_req_t *req)
+ *	@brief 		State of the six-position accelero calibration and last fit
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t accel_calibration_get_handler(httpd_req_t *req)
+{
+    static const char *state_name[] = {"idle", "waiting", "capturing", "done", "failed"};
+    static const char *face_name[ACCEL_CALIB_FACES] = {"+x", "-x", "+y", "-y", "+z", "-z"};
+    accel_calib_status_t status;
 
-        /*--- Compute travel2 ---*/
-        travel2 = g_chordControlSurface * sin((angle2 * (2.0 * PI) / 360.0) / 2.0) * 2.0;
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL)
+    {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
+    }
 
-        ESP_LOGI(TAG, "angle2 : %.1f - travel2 : %.1f - voltage2 : %.2f\n", angle2, travel2, voltage2);
+    accel_calib_status(&status);
+    cJSON_AddStringToObject(root, "state", state_name[status.state]);
+    cJSON_AddNumberToObject(root, "sensor", status.sensor);
+    if (status.error != NULL)
+    {
+        cJSON_AddStringToObject(root, "error", status.error);
+    }
 
-        remaining -= ret;
+    cJSON *faces = cJSON_AddArrayToObject(root, "faces");
+    for (int i = 0; faces != NULL && i < ACCEL_CALIB_FACES; i++)
+    {
+        if (status.faces & (1 << i))
+        {
+            cJSON_AddItemToArray(faces, cJSON_CreateString(face_name[i]));
+        }
+    }
+    if (status.lastFace >= 0)
+    {
+        cJSON_AddStringToObject(root, "last_face", face_name[status.lastFace]);
     }
 
-    ESP_LOGI(TAG, "Exit ----> sensor2_post_handler()\n");
+    if (status.state == ACCEL_CALIB_DONE)
+    {
+        cJSON *fit = cJSON_AddObjectToObject(root, "fit");
+        if (fit != NULL)
+        {
+            cJSON_AddItemToObject(fit, "scale", cJSON_CreateFloatArray(status.scale, 3));
+            cJSON_AddItemToObject(fit, "bias_mg", cJSON_CreateFloatArray(status.biasMg, 3));
+            cJSON_AddNumberToObject(fit, "cross_axis", status.crossAxis);
+            cJSON_AddNumberToObject(fit, "residual_mg", status.residualMg);
+        }
+    }
 
-    char response[96];
-    int resp_len = snprintf(response, sizeof(response), "{\"targetAngle\":%0.2f,\"targetActive\":%d}", g_targetAngle, g_targetAngleActive ? 1 : 0);
-    if (resp_len < 0 || resp_len >= (int)sizeof(response))
+    char *json = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json == NULL)
     {
-        resp_len = snprintf(response, sizeof(response), "{\"targetAngle\":0.0,\"targetActive\":0}");
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "JSON allocation error");
+        return ESP_FAIL;
     }
 
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, response, resp_len);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_sendstr(req, json);
+    cJSON_free(json);
 
     return ESP_OK;
+}
 
-} /* end sensor2_post_handler() */
-
-httpd_uri_t sensor2 = {
+httpd_uri_t accel_calibration_get_uri = {
 
-    .uri = "/sensor2",
+    .uri = "/accel_calibration",
 
-    .method = HTTP_POST,
+    .method = HTTP_GET,
 
-    .handler = sensor2_post_handler,
+    .handler = accel_calibration_get_handler,
 
     .user_ctx = NULL
 
 };
 
-esp_err_t target_angle_post_handler(httpd_req_t *req)
+/**
+ *	@fn 	    esp_err_t accel_calibration_post_handler(httpd_req_t *req)
+ *	@brief 		Step of the six-position calibration, body {"action":"start","sensor":0}, then
+ *				{"action":"capture"} once per face, {"action":"cancel"} or {"action":"clear","sensor":0}
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t accel_calibration_post_handler(httpd_req_t *req)
 {
-    char buf[64];
-    int ret;
-    int remaining = req->content_len;
-    int offset = 0;
-
-    ESP_LOGI(TAG, "Entering ----> target_angle_post_handler()\n");
+    static const char *action_name[] = {"start", "capture", "cancel", "clear"};
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
 
-    memset(buf, 0, sizeof(buf));
+    ESP_LOGI(TAG, "Entering ----> accel_calibration_post_handler()\n");
 
-    while (remaining > 0)
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
     {
-        if (offset >= (int)(sizeof(buf) - 1))
-        {
-            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Payload too large");
-            return ESP_FAIL;
-        }
+        return ESP_FAIL;
+    }
 
-        ret = httpd_req_recv(req, buf + offset, MIN(remaining, (int)(sizeof(buf) - 1 - offset)));
-        if (ret <= 0)
+    int action = -1;
+    for (int i = 0; i < (int)(sizeof(action_name) / sizeof(action_name[0])); i++)
+    {
+        if (json_equals(&doc, "action", action_name[i]))
         {
-            if (ret == HTTPD_SOCK_ERR_TIMEOUT)
-            {
-                continue;
-            }
-            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to receive body");
-            return ESP_FAIL;
+            action = i;
         }
-        remaining -= ret;
-        offset += ret;
     }
 
-    cJSON *root = cJSON_Parse(buf);
-    if (!root)
+    int32_t sensor = 0;
+    json_get_int(&doc, "sensor", &sensor);
+
+    if (action < 0)
     {
-        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Invalid JSON");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "action missing or unknown");
         return ESP_FAIL;
     }
 
-    const cJSON *target_angle_value = cJSON_GetObjectItemCaseSensitive(root, "targetAngle");
-    if (!cJSON_IsNumber(target_angle_value))
+    if (sensor < 0 || sensor >= g_sensorCount)
     {
-        cJSON_Delete(root);
-        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "targetAngle missing");
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Unknown sensor");
         return ESP_FAIL;
     }
 
-    g_targetAngle = target_angle_value->valuedouble;
-    g_targetAngleActive = true;
+    if (action == ACCEL_CALIB_START && g_calibrationState != CALIBRATION_DONE)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "offset calibration running");
+        return ESP_FAIL;
+    }
 
-    cJSON_Delete(root);
+    if (!accel_calib_request((accel_calib_action_t)action, sensor))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "action not allowed in this state");
+        return ESP_FAIL;
+    }
 
     httpd_resp_set_type(req, "application/json");
     httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
 
-    ESP_LOGI(TAG, "Exit ----> target_angle_post_handler()\n");
+    ESP_LOGI(TAG, "Exit ----> accel_calibration_post_handler()\n");
 
     return ESP_OK;
 }
 
-httpd_uri_t target_angle_uri = {
+httpd_uri_t accel_calibration_post_uri = {
 
-    .uri = "/target_angle",
+    .uri = "/accel_calibration",
 
     .method = HTTP_POST,
 
-    .handler = target_angle_post_handler,
+    .handler = accel_calibration_post_handler,
 
     .user_ctx = NULL
 
 };
 
-esp_err_t reset_post_handler(httpd_req_t *req)
+/**
+ *	@fn 	    esp_err_t calibration_get_handler(httpd_req_t *req)
+ *	@brief 		State of the offset calibration of the MPU6050s
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t calibration_get_handler(httpd_req_t *req)
 {
+    static const char *state_name[] = {"boot", "done", "running"};
+    char json[96];
 
-    ESP_LOGI(TAG, "Entering ----> reset_post_handler()\n");
+    snprintf(json, sizeof(json), "{\"state\":\"%s\",\"progress\":%u,\"restarts\":%u}",
+             state_name[g_calibrationState], g_calibrationProgress, g_calibrationRestarts);
 
-    g_travelZeroOffset = g_travel;
-    g_travel2ZeroOffset = travel2;
-    g_angleZeroOffset = g_angle;
-    g_angle2ZeroOffset = angle2;
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+    httpd_resp_sendstr(req, json);
+
+    return ESP_OK;
+}
+
+httpd_uri_t calibration_get_uri = {
+
+    .uri = "/calibration",
+
+    .method = HTTP_GET,
+
+    .handler = calibration_get_handler,
+
+    .user_ctx = NULL
+
+};
+
+/**
+ *	@fn 	    esp_err_t calibration_post_handler(httpd_req_t *req)
+ *	@brief 		Start a recalibration of the offsets, body {"run":true}. The measure goes on meanwhile.
+ *	@param[in]	req : httpd request
+ *	@return		ESP_OK or ESP_FAIL
+ */
+esp_err_t calibration_post_handler(httpd_req_t *req)
+{
+    char buf[POST_BODY_MAX_SIZE];
+    json_tok_t tokens[JSON_SMALL_TOKENS];
+    json_doc_t doc;
+    accel_calib_status_t accel;
+
+    ESP_LOGI(TAG, "Entering ----> calibration_post_handler()\n");
+
+    if (!body_json(req, &doc, buf, sizeof(buf), tokens, JSON_SMALL_TOKENS))
+    {
+        return ESP_FAIL;
+    }
+
+    bool run = false;
+    if (!json_get_bool(&doc, "run", &run))
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "run missing");
+        return ESP_FAIL;
+    }
+    if (!run)
+    {
+        /*--- A calibration cannot be stopped : the previous offsets are kept until it is over ---*/
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "run must be true");
+        return ESP_FAIL;
+    }
+
+    accel_calib_status(&accel);
+    if (g_calibrationState != CALIBRATION_DONE || accel.state == ACCEL_CALIB_WAITING || accel.state == ACCEL_CALIB_CAPTURING)
+    {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "calibration already running");
+        return ESP_FAIL;
+    }
+
+    MEASURE_REQUEST(MEASURE_REQUEST_CALIBRATION);
 
-    const char *resp = "{\"status\":\"ok\"}";
     httpd_resp_set_type(req, "application/json");
-    httpd_resp_send(req, resp, strlen(resp));
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
 
-    ESP_LOGI(TAG, "Exit ----> reset_post_handler()\n");
+    ESP_LOGI(TAG, "Exit ----> calibration_post_handler()\n");
 
     return ESP_OK;
 }
 
-httpd_uri_t reset_uri = {
+httpd_uri_t calibration_post_uri = {
 
-    .uri = "/reset",
+    .uri = "/calibration",
 
     .method = HTTP_POST,
 
-    .handler = reset_post_handler,
+    .handler = calibration_post_handler,
 
     .user_ctx = NULL
 
@@ -537,6 +1340,39 @@ static const char *task_state_to_string(eTaskState state)
     }
 }
 
+#if CONFIG_PM_ENABLE && CONFIG_PM_PROFILING
+/**
+ *	@fn 	    static bool pm_sleep_stats(long long *sleep_us, int *sleep_percent)
+ *	@brief 		Time spent since boot with no PM lock held (light sleep allowed), read from
+ *	            the "SLEEP" line of the esp_pm profiling dump.
+ *	@param[out]	sleep_us : time in us
+ *	@param[out]	sleep_percent : percentage of the time since boot
+ *	@return		true if found
+ */
+static bool pm_sleep_stats(long long *sleep_us, int *sleep_percent)
+{
+    char *dump = NULL;
+    size_t size = 0;
+    bool found = false;
+
+    FILE *stream = open_memstream(&dump, &size);
+    if (stream == NULL)
+    {
+        return false;
+    }
+    esp_pm_dump_locks(stream);
+    fclose(stream);
+
+    for (char *line = strtok(dump, "\n"); line != NULL && !found; line = strtok(NULL, "\n"))
+    {
+        found = sscanf(line, "SLEEP %*[^M]M %lld %d%%", sleep_us, sleep_percent) == 2;
+    }
+    free(dump);
+
+    return found;
+}
+#endif
+
 esp_err_t runtime_stats_get_handler(httpd_req_t *req)
 {
     UBaseType_t task_count = uxTaskGetNumberOfTasks();
@@ -563,6 +1399,74 @@ esp_err_t runtime_stats_get_handler(httpd_req_t *req)
     cJSON_AddNumberToObject(root, "total_runtime_ticks", total_run_time);
     cJSON_AddNumberToObject(root, "tasks_reported", valid_tasks);
 
+    /*--- I2C health of the MPU6050 link ---*/
+    cJSON *i2c = cJSON_AddObjectToObject(root, "i2c");
+    if (i2c != NULL)
+    {
+        cJSON_AddNumberToObject(i2c, "errors", g_i2cErrors);
+        cJSON_AddNumberToObject(i2c, "retries", g_i2cRetries);
+        cJSON_AddNumberToObject(i2c, "recoveries", g_i2cRecoveries);
+        cJSON_AddNumberToObject(i2c, "skipped_samples", g_skippedSamples);
+    }
+
+    /*--- Accelero prefilter : spikes removed by the median, samples out of the 1 g gate ---*/
+    cJSON *accel = cJSON_AddObjectToObject(root, "accel");
+    if (accel != NULL)
+    {
+        cJSON_AddNumberToObject(accel, "spikes", g_accelSpikes);
+        cJSON_AddNumberToObject(accel, "gated", g_accelGated);
+    }
+
+    /*--- Online gyro bias estimation (updated while the surface is still) ---*/
+    cJSON *gyro = cJSON_AddObjectToObject(root, "gyro");
+    if (gyro != NULL)
+    {
+        cJSON_AddBoolToObject(gyro, "still", g_still);
+        cJSON_AddNumberToObject(gyro, "bias_dps", g_gyroBias);
+        cJSON_AddNumberToObject(gyro, "temperature", g_mpuTemperature);
+    }
+
+#if ESP_MAD_ATTITUDE_3D
+    /*--- 3-D attitude : hinge axis known, time of an update + hinge angle over the last second ---*/
+    cJSON *attitude = cJSON_AddObjectToObject(root, "attitude");
+    if (attitude != NULL)
+    {
+        cJSON_AddBoolToObject(attitude, "hinge_learnt", g_hingeLearnt);
+        cJSON_AddNumberToObject(attitude, "update_us", g_attitudeUs);
+        cJSON_AddNumberToObject(attitude, "update_max_us", g_attitudeMaxUs);
+    }
+#endif
+
+    /*--- Battery reading : ADC continuous mode, noise of the frame and age of the reading ---*/
+    cJSON *battery = cJSON_AddObjectToObject(root, "battery");
+    if (battery != NULL)
+    {
+        cJSON_AddNumberToObject(battery, "mv", g_voltage);
+        cJSON_AddNumberToObject(battery, "noise_mv", g_voltageNoise);
+        cJSON_AddNumberToObject(battery, "age_ms", g_voltageTimestamp > 0 ? (double)((esp_timer_get_time() - g_voltageTimestamp) / 1000) : -1.0);
+    }
+
+    /*--- Power management : current CPU clock and time allowed to light sleep ---*/
+    cJSON *pm = cJSON_AddObjectToObject(root, "pm");
+    if (pm != NULL)
+    {
+#if CONFIG_PM_ENABLE
+        cJSON_AddBoolToObject(pm, "enabled", true);
+#else
+        cJSON_AddBoolToObject(pm, "enabled", false);
+#endif
+        cJSON_AddNumberToObject(pm, "cpu_mhz", esp_rom_get_cpu_ticks_per_us());
+#if CONFIG_PM_ENABLE && CONFIG_PM_PROFILING
+        long long sleep_us;
+        int sleep_percent;
+        if (pm_sleep_stats(&sleep_us, &sleep_percent))
+        {
+            cJSON_AddNumberToObject(pm, "sleep_us", (double)sleep_us);
+            cJSON_AddNumberToObject(pm, "sleep_percent", sleep_percent);
+        }
+#endif
+    }
+
     cJSON *tasks = cJSON_AddArrayToObject(root, "tasks");
     if (tasks == NULL)
     {
@@ -636,71 +1540,47 @@ httpd_uri_t runtime_stats = {
 esp_err_t chord_post_handler(httpd_req_t *req)
 {
 
-    char buf[50];
+    char buf[POST_BODY_MAX_SIZE];
 
-    char param[3];
+    char resp[64];
 
-    int oldchordValue = g_chordControlSurface;
+    form_t form;
 
-    int ret, remaining = req->content_len;
+    int oldchordValue = g_chordControlSurface;
 
-    int iTemp;
+    int32_t chord;
 
     ESP_LOGI(TAG, "Entering ----> chord_post_handler()\n");
     ESP_LOGI(TAG, "method: %d\n", req->method);
     ESP_LOGI(TAG, "uri: %s\n", req->uri);
 
-    while (remaining > 0)
+    /*--- chordValue=NN in the body, or in the query string ---*/
+    if (!body_form(req, &form, buf, sizeof(buf)))
     {
+        return ESP_FAIL;
+    }
 
-        /* Read the data for the request */
-
-        if ((ret = httpd_req_recv(req, buf,
-
-                                  MIN(remaining, sizeof(buf)))) <= 0)
-        {
-
-            if (ret == HTTPD_SOCK_ERR_TIMEOUT)
-            {
-
-                /* Retry receiving if timeout occurred */
-
-                continue;
-            }
-
-            return ESP_FAIL;
-        }
-
-        /* Log data received */
-
-        ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
-
-        ESP_LOGI(TAG, "%.*s", ret, buf);
-
-        ESP_LOGI(TAG, "====================================");
-
-        param[0] = buf[11];
-        param[1] = buf[12];
-        param[2] = '\0';
+    /* Log data received */
 
-        iTemp = atoi(param);
+    ESP_LOGI(TAG, "=========== RECEIVED DATA ==========");
 
-        if (iTemp > 0)
-        {
+    ESP_LOGI(TAG, "%.*s", (int)form.len, form.data);
 
-            g_chordControlSurface = iTemp;
+    ESP_LOGI(TAG, "====================================");
 
-            sprintf(buf, "Changing chord from %d mm to %d mm\n", oldchordValue, g_chordControlSurface);
-        }
-        else
-            sprintf(buf, "ERROR : chord must be a positive value\n");
+    if (form_get_int(&form, "chordValue", CHORD_MIN_MM, CHORD_MAX_MM, &chord))
+    {
 
-        /* Send response to the client */
-        httpd_resp_set_type(req, "text/plain");
-        httpd_resp_send(req, buf, strlen(buf));
+        g_chordControlSurface = chord;
 
-        remaining -= ret;
+        snprintf(resp, sizeof(resp), "Changing chord from %d mm to %d mm\n", oldchordValue, g_chordControlSurface);
     }
+    else
+        snprintf(resp, sizeof(resp), "ERROR : chord must be %d to %d mm\n", CHORD_MIN_MM, CHORD_MAX_MM);
+
+    /* Send response to the client */
+    httpd_resp_set_type(req, "text/plain");
+    httpd_resp_send(req, resp, strlen(resp));
 
     ESP_LOGI(TAG, "Exit    ----> chord_post_handler()\n");
 
@@ -732,7 +1612,7 @@ httpd_handle_t start_webserver(void)
     httpd_handle_t server = NULL;
 
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.max_uri_handlers = 12;
+    config.max_uri_handlers = 24;
 
     // Start the httpd server
 
@@ -765,6 +1645,26 @@ httpd_handle_t start_webserver(void)
 
         httpd_register_uri_handler(server, &runtime_stats);
 
+        httpd_register_uri_handler(server, &profile_get_uri);
+
+        httpd_register_uri_handler(server, &profile_post_uri);
+
+        httpd_register_uri_handler(server, &sweep_get_uri);
+
+        httpd_register_uri_handler(server, &sweep_post_uri);
+
+        httpd_register_uri_handler(server, &jitter_get_uri);
+
+        httpd_register_uri_handler(server, &jitter_post_uri);
+
+        httpd_register_uri_handler(server, &accel_calibration_get_uri);
+
+        httpd_register_uri_handler(server, &accel_calibration_post_uri);
+
+        httpd_register_uri_handler(server, &calibration_get_uri);
+
+        httpd_register_uri_handler(server, &calibration_post_uri);
+
         return server;
     }
 
@@ -978,18 +1878,7 @@ void task_http_server(void *ignore)
 
 {
 
-    /*--- Initialize nvs partition ---*/
-    esp_err_t ret = nvs_flash_init();
-
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
-    {
-
-        ESP_ERROR_CHECK(nvs_flash_erase());
-
-        ret = nvs_flash_init();
-    }
-
-    ESP_ERROR_CHECK(ret);
+    /*--- nvs partition initialized by app_main() ---*/
 
     /*--- start dhcp_server to serve stations ---*/
  //   start_dhcp_server();
@@ -997,12 +1886,6 @@ void task_http_server(void *ignore)
     /*--- start wifi driver in AP mode ---*/
     initialise_wifi_in_ap();
 
-    /*--- infinite loop to serve wifi event and http request ---*/
-    while (1)
-    {
-        vTaskDelay(300 / portTICK_PERIOD_MS);
-    } /* end while() */
-
-    /*--- this part will not be executed but we stick the free rtos reco. ---*/
+    /*--- wifi events and http requests are served by the esp_event and httpd tasks ---*/
     vTaskDelete(NULL);
 }
\ No newline at end of file
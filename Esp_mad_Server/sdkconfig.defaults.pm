@@ -0,0 +1,12 @@
+## Power managed build profile, on top of sdkconfig.defaults :
+##   idf.py -D SDKCONFIG_DEFAULTS="sdkconfig.defaults;sdkconfig.defaults.pm" build
+
+# Dynamic frequency scaling, configured by power_management_init() in esp_mad.cpp.
+CONFIG_PM_ENABLE=y
+
+# Time spent in each power mode, reported by /runtime_stats.
+CONFIG_PM_PROFILING=y
+
+# Tickless idle : automatic light sleep when no task is ready and no PM lock is held.
+CONFIG_FREERTOS_USE_TICKLESS_IDLE=y
+CONFIG_FREERTOS_IDLE_TIME_BEFORE_SLEEP=3
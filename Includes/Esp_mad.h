@@ -43,9 +43,99 @@
     #define BLINK_GPIO  (gpio_num_t)ESP_MAD_DEFAULT_LED_GPIO
 #endif
 
+#ifndef BATT_ADC_CHANNEL
+    #define BATT_ADC_CHANNEL    ESP_MAD_DEFAULT_BATT_CH     /* ADC1 channel of the battery sense bridge (GPIO1 on C3) */
+#endif
+
+/*
+ * 1S LiPo of the board : capacity for the runtime estimate, state of charge under which the low_power
+ * acquisition profile is selected (0 disables it, also set through /profile "low_battery_soc").
+ */
+#ifndef BATT_CAPACITY_MAH
+    #define BATT_CAPACITY_MAH   500
+#endif
+
+#ifndef BATT_LOW_POWER_SOC
+    #define BATT_LOW_POWER_SOC  20
+#endif
+
+/*
+ * Angle computation
+ * - 1 : 3-D attitude (quaternion), the sensor may be clipped in any orientation, angle is taken about
+ *       the hinge axis from the reference orientation captured at boot and by /reset.
+ * - 0 : historical single axis angle (atan2(ax, az) and gy), filter chosen by ESP_MAD_FUSION_FILTER.
+ */
+#ifndef ESP_MAD_ATTITUDE_3D
+    #define ESP_MAD_ATTITUDE_3D 1
+#endif
+
+/*
+ * Attitude updates timed together : mean and max published in /runtime_stats (1 s at 100 Hz)
+ */
+#define ATTITUDE_STATS_SAMPLES 100
+
 #ifndef TARGET_LED_GPIO
     #define TARGET_LED_GPIO  (gpio_num_t)ESP_MAD_TARGET_LED_GPIO
 #endif
 
+/*
+ * Lowest CPU frequency of the dynamic frequency scaling, power managed build only
+ * (CONFIG_PM_ENABLE, see Esp_mad_Server/sdkconfig.defaults.pm). 40 MHz is the XTAL frequency.
+ */
+#ifndef ESP_MAD_PM_MIN_FREQ_MHZ
+    #define ESP_MAD_PM_MIN_FREQ_MHZ 40
+#endif
+
+/*
+ * Calibration state of the MPU6050s (g_calibrationState)
+ * - CALIBRATION_BOOT    : first calibration after power-on, no measure yet
+ * - CALIBRATION_DONE    : offsets set, measure running
+ * - CALIBRATION_RUNNING : recalibration requested through /calibration, the measure goes on with the
+ *                         previous offsets until the new ones are swapped in
+ */
+#define CALIBRATION_BOOT        0
+#define CALIBRATION_DONE        1
+#define CALIBRATION_RUNNING     2
+
+/*
+ * Requests of the HTTP tasks to the measure task (g_measureRequests). MEASURE_REQUEST() sets them with an
+ * atomic or; the measure task takes the ones it can serve with an atomic and, the others stay pending
+ * (e.g. a zero request during the boot calibration is served once it is over).
+ * - MEASURE_REQUEST_REFERENCE   : capture the reference orientation (/reset)
+ * - MEASURE_REQUEST_CALIBRATION : recalibration of the offsets (/calibration)
+ * - MEASURE_REQUEST_HINGE       : learn the hinge axis again (/reset hinge=relearn)
+ */
+#define MEASURE_REQUEST_REFERENCE   (1u << 0)
+#define MEASURE_REQUEST_CALIBRATION (1u << 1)
+#define MEASURE_REQUEST_HINGE       (1u << 2)
+#define MEASURE_REQUEST(bits)       __atomic_fetch_or(&g_measureRequests, (uint32_t)(bits), __ATOMIC_RELEASE)
+
+/*
+ * Target led bands (g_targetBand) : settled angle - zero offset - target angle gives bands 1 (green)
+ * to 6 (red), limits and colours in extra_components/esp_mad_indicator/esp_mad_target.h.
+ * TARGET_BAND_OFF while no target is set.
+ */
+#define TARGET_BAND_OFF         0
+
+/*
+ * WS2812 leds on TARGET_LED_GPIO : 1 for a single colour / blink led, more for a bar graph of the
+ * signed deviation (middle led on target).
+ */
+#ifndef TARGET_LED_COUNT
+    #define TARGET_LED_COUNT    1
+#endif
+
+/*
+ * Chord of the control surface accepted by /chord (g_chordControlSurface), mm
+ */
+#define CHORD_MIN_MM            1
+#define CHORD_MAX_MM            1000
+
+/*
+ * MPU6050 INT pin. When defined, the motion interrupt wakes the measure task up from the low-power
+ * idle mode; otherwise the interrupt status is polled at the loop period of the acquisition profile.
+ * e.g. #define MPU_INT_GPIO 4
+ */
+
 #endif /* _ESP_MAD_H_ */
  
\ No newline at end of file
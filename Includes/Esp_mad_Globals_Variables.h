@@ -25,17 +25,52 @@
     #define INITIALIZER(...)    /* nothing */
 #endif /* DEFINE_VARIABLES */
 
-EXTERN bool BInit INITIALIZER(0);                   /* Boolean used to indicated if the MPU6050 is calibrated or not    */
+EXTERN uint8_t g_calibrationState INITIALIZER(CALIBRATION_BOOT); /* MPU6050 offsets : boot, done or running (see Esp_mad.h) */
 EXTERN float g_travel INITIALIZER(0.0);             /* Store the travel measure by the MPU6050                          */
 EXTERN float g_angle INITIALIZER(0.0);              /* Store the angle measure by the MPU6050                           */                           
 EXTERN int g_chordControlSurface INITIALIZER(50);   /* Store the chord of the Control surface in mm. 50 mm by default   */
 EXTERN uint32_t g_voltage INITIALIZER(0);           /* Store the voltage of the battery                                 */
+EXTERN uint32_t g_voltageNoise INITIALIZER(0);      /* Standard deviation of the battery conversions in mV              */
+EXTERN int64_t g_voltageTimestamp INITIALIZER(0);   /* esp_timer_get_time() of the battery reading, 0 before the first  */
+EXTERN int8_t g_batterySoc INITIALIZER(-1);         /* Battery state of charge in %, -1 before the first reading        */
+EXTERN int32_t g_batteryRuntimeMin INITIALIZER(-1); /* Remaining runtime at the present load in minutes, -1 if unknown  */
+EXTERN uint32_t g_batteryLoadMa INITIALIZER(0);     /* Load estimated from the operating mode (see esp_mad_battery.c)   */
+EXTERN uint8_t g_lowBatterySoc INITIALIZER(BATT_LOW_POWER_SOC); /* State of charge selecting the low_power profile, 0 : never */
+EXTERN bool g_lowBattery INITIALIZER(false);        /* low_power profile selected by the battery monitor                */
 EXTERN float g_travelZeroOffset INITIALIZER(0.0);   /* Store zero reference for travel1                                 */
 EXTERN float g_travel2ZeroOffset INITIALIZER(0.0);  /* Store zero reference for travel2                                 */
 EXTERN float g_angleZeroOffset INITIALIZER(0.0);    /* Store zero reference for angle1                                  */
 EXTERN float g_angle2ZeroOffset INITIALIZER(0.0);   /* Store zero reference for angle2                                  */
 EXTERN float g_targetAngle INITIALIZER(0.0);        /* Target angle entered from UI                                     */
 EXTERN bool g_targetAngleActive INITIALIZER(false); /* Flag to indicate if target LED feature is active                 */
+EXTERN uint8_t g_targetBand INITIALIZER(TARGET_BAND_OFF); /* Target led band computed by the measure task (see Esp_mad.h) */
+EXTERN uint32_t g_i2cErrors INITIALIZER(0);         /* I2C transactions to the MPU6050 given up after all retries       */
+EXTERN uint32_t g_i2cRetries INITIALIZER(0);        /* I2C transactions to the MPU6050 retried                          */
+EXTERN uint32_t g_i2cRecoveries INITIALIZER(0);     /* I2C bus recoveries (SCL toggling + driver re-install)            */
+EXTERN uint32_t g_skippedSamples INITIALIZER(0);    /* MPU6050 samples skipped by the measure loop after a bus error    */
+EXTERN uint32_t g_accelSpikes INITIALIZER(0);       /* Accelero samples with an axis replaced by its median (spike)     */
+EXTERN uint32_t g_accelGated INITIALIZER(0);        /* Accelero samples rejected by the 1 g magnitude gate              */
+EXTERN bool g_still INITIALIZER(false);             /* Control surface detected static by the measure loop              */
+EXTERN float g_gyroBias INITIALIZER(0.0);           /* Gyro Y bias (temperature model + still estimate), in deg/s       */
+EXTERN float g_mpuTemperature INITIALIZER(0.0);     /* MPU6050 die temperature in °C, updated once a second             */
+EXTERN uint8_t g_sensorCount INITIALIZER(0);        /* MPU6050 found on the I2C bus of this board (0x68, 0x69)          */
+EXTERN float g_angleSensor2 INITIALIZER(0.0);       /* Angle measured by the second MPU6050 of this board (settled)     */
+EXTERN float g_travelSensor2 INITIALIZER(0.0);      /* Travel measured by the second MPU6050 of this board (settled)    */
+EXTERN uint8_t g_acquisitionProfile INITIALIZER(1); /* Acquisition profile in use (see esp_mad_profile.cpp)             */
+EXTERN int8_t g_profileRequest INITIALIZER(-1);     /* Acquisition profile requested through the HTTP API, -1 if none   */
+EXTERN bool g_profileRequestTransient INITIALIZER(false); /* g_profileRequest from the battery monitor, not saved in NVS */
+EXTERN uint16_t g_idleTimeoutS INITIALIZER(60);     /* Stillness time before the low-power idle mode, 0 to disable      */
+EXTERN bool g_idle INITIALIZER(false);              /* MPU6050s in low-power cycle mode, waiting for motion             */
+EXTERN bool g_settled INITIALIZER(false);           /* Angle steady over the settle window (see esp_mad_settle.cpp)     */
+EXTERN float g_angleSettled INITIALIZER(0.0);       /* Window mean angle when g_settled, instantaneous angle otherwise  */
+EXTERN float g_travelSettled INITIALIZER(0.0);      /* Travel of g_angleSettled                                         */
+EXTERN float g_angleConfidence INITIALIZER(0.0);    /* 95 % confidence half interval of the settled angle, in degree    */
+EXTERN uint8_t g_calibrationProgress INITIALIZER(0);/* Samples averaged by the running calibration, in %                */
+EXTERN uint16_t g_calibrationRestarts INITIALIZER(0);/* Calibration windows restarted because a surface moved           */
+EXTERN uint32_t g_measureRequests INITIALIZER(0);   /* Requests pending for the measure task (see Esp_mad.h)            */
+EXTERN bool g_hingeLearnt INITIALIZER(false);       /* Hinge axis of the first MPU6050 learnt or restored from NVS      */
+EXTERN uint32_t g_attitudeUs INITIALIZER(0);        /* Mean time of an attitude update + hinge angle, in us             */
+EXTERN uint32_t g_attitudeMaxUs INITIALIZER(0);     /* Longest attitude update + hinge angle, in us                     */
 
 #endif /* _ESP_MAD_GLOBALS_VARIABLES_H_ */
  
\ No newline at end of file
@@ -35,27 +35,26 @@ THE SOFTWARE.
 */
 
 #include "MPU6050.h"
+#include "MPU6050_RegisterMap.h"
 #include <string.h>
 
 #define I2C_NUM I2C_NUM_0
 
-void MPU6050::ReadRegister(uint8_t reg, uint8_t *data, uint8_t len){
-	uint8_t dev = 0x68;
-	i2c_cmd_handle_t cmd;
-	I2Cdev::SelectRegister(dev, reg);
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (dev << 1) | I2C_MASTER_READ, 1));
-
-	if(len>1)
-		ESP_ERROR_CHECK(i2c_master_read(cmd, data, len, (i2c_ack_type_t)0));
-
-	ESP_ERROR_CHECK(i2c_master_read_byte(cmd, data+len-1, (i2c_ack_type_t)1));
+/** Registers of the MPU6050 which may live in the I2Cdev register shadow.
+ * Only plain configuration registers are flagged: offsets and fine gains
+ * (0x00-0x0B, 0x13-0x18), SMPLRT_DIV to I2C_SLV4_CTRL (0x19-0x34), INT_PIN_CFG,
+ * INT_ENABLE, I2C_SLVx_DO, I2C_MST_DELAY_CTRL, MOT_DETECT_CTRL, PWR_MGMT_1 and
+ * PWR_MGMT_2. Data, status, FIFO, DMP memory and the registers holding
+ * self-clearing reset bits (SIGNAL_PATH_RESET, USER_CTRL) always go to the bus.
+ * PWR_MGMT_1 DEVICE_RESET is handled by reset() which drops the whole shadow.
+ */
+static const uint8_t MPU6050_SHADOW_MAP[I2CDEV_SHADOW_MAP_SIZE] = {
+    0xFF, 0x0F, 0xF8, 0xFF, 0xFF, 0xFF, 0x9F, 0x01,    // 0x00 - 0x3F
+    0x00, 0x00, 0x00, 0x00, 0xF8, 0x1A, 0x00, 0x00     // 0x40 - 0x7F
+};
 
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000));
-	i2c_cmd_link_delete(cmd);
+void MPU6050::ReadRegister(uint8_t reg, uint8_t *data, uint8_t len){
+	I2Cdev::readBytes(devAddr, reg, len, data);
 }
 
 
@@ -84,10 +83,57 @@ MPU6050::MPU6050(uint8_t address) {
  * the default internal clock source.
  */
 void MPU6050::initialize() {
-    setClockSource(MPU6050_CLOCK_PLL_XGYRO);
-    setFullScaleGyroRange(MPU6050_GYRO_FS_250);
-    setFullScaleAccelRange(MPU6050_ACCEL_FS_2);
-    setSleepEnabled(false); // thanks to Jack Elston for pointing this one out!
+    using namespace MPU6050_Reg;
+
+    // GYRO_CONFIG and ACCEL_CONFIG are consecutive: one burst for both ranges
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<FS_SEL>(MPU6050_GYRO_FS_250),
+                                   I2CdevRegister::set<AFS_SEL>(MPU6050_ACCEL_FS_2));
+    // clock source and sleep share PWR_MGMT_1: one read-modify-write
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<CLKSEL>(MPU6050_CLOCK_PLL_XGYRO),
+                                   I2CdevRegister::set<SLEEP>(false)); // thanks to Jack Elston for pointing this one out!
+}
+
+/** Set the acquisition configuration in a single burst.
+ * SMPLRT_DIV, CONFIG, GYRO_CONFIG and ACCEL_CONFIG are consecutive registers,
+ * they are written with one transaction instead of four read-modify-write.
+ * @param rateDiv Sample rate divider (see setRate())
+ * @param dlpfMode Digital low-pass filter configuration (see setDLPFMode())
+ * @param gyroRange Full-scale gyroscope range (see setFullScaleGyroRange())
+ * @param accelRange Full-scale accelerometer range (see setFullScaleAccelRange())
+ * @return Status of operation (true = success)
+ */
+bool MPU6050::setAcquisitionConfig(uint8_t rateDiv, uint8_t dlpfMode, uint8_t gyroRange, uint8_t accelRange) {
+    using namespace MPU6050_Reg;
+
+    return I2CdevRegister::write(devAddr, I2CdevRegister::set<RATE_DIV>(rateDiv),
+                                          I2CdevRegister::set<DLPF_CFG>(dlpfMode),
+                                          I2CdevRegister::set<FS_SEL>(gyroRange),
+                                          I2CdevRegister::set<AFS_SEL>(accelRange));
+}
+
+/** Enter or leave the accelerometer only low power mode.
+ * In this mode the device sleeps and wakes up at the given frequency to take a
+ * single accelerometer sample, gyroscopes and temperature sensor are in standby
+ * and the internal oscillator is used as clock. When leaving it, the clock is
+ * back on the X gyro PLL and every sensor is enabled. PWR_MGMT_1 and PWR_MGMT_2
+ * are consecutive, they are written in one burst.
+ * @param enabled New low power mode status
+ * @param wakeFrequency Wake-up frequency (LP_WAKE_CTRL), 0 to 3 = 1.25, 5, 20, 40 Hz on the MPU-6050
+ * @return Status of operation (true = success)
+ * @see setWakeCycleEnabled()
+ * @see setWakeFrequency()
+ * @see MPU6050_RA_PWR_MGMT_1
+ * @see MPU6050_RA_PWR_MGMT_2
+ */
+bool MPU6050::setLowPowerAccelMode(bool enabled, uint8_t wakeFrequency) {
+    using namespace MPU6050_Reg;
+    using I2CdevRegister::set;
+
+    return I2CdevRegister::write(devAddr, set<SLEEP>(false), set<CYCLE>(enabled), set<TEMP_DIS>(enabled),
+                                          set<CLKSEL>(enabled ? MPU6050_CLOCK_INTERNAL : MPU6050_CLOCK_PLL_XGYRO),
+                                          set<LP_WAKE_CTRL>(wakeFrequency),
+                                          set<STBY_XA>(false), set<STBY_YA>(false), set<STBY_ZA>(false),
+                                          set<STBY_XG>(enabled), set<STBY_YG>(enabled), set<STBY_ZG>(enabled));
 }
 
 /** Verify the I2C connection.
@@ -98,6 +144,22 @@ bool MPU6050::testConnection() {
     return getDeviceID() == 0x34;
 }
 
+/** Enable or disable the configuration register shadow.
+ * With the shadow enabled, bit-field setters are computed from a RAM copy of
+ * the register and cost a single write transaction, and offset or configuration
+ * writes which would not change the register are skipped.
+ * @param enabled true to enable the shadow, false to disable it
+ * @return Status of operation (true = success)
+ * @see I2Cdev::enableShadow()
+ */
+bool MPU6050::setRegisterShadowEnabled(bool enabled) {
+    if (!enabled) {
+        I2Cdev::disableShadow(devAddr);
+        return true;
+    }
+    return I2Cdev::enableShadow(devAddr, MPU6050_SHADOW_MAP);
+}
+
 // AUX_VDDIO register (InvenSense demo code calls this RA_*G_OFFS_TC)
 
 /** Get the auxiliary I2C supply voltage level.
@@ -144,8 +206,7 @@ void MPU6050::setAuxVDDIOLevel(uint8_t level) {
  * @see MPU6050_RA_SMPLRT_DIV
  */
 uint8_t MPU6050::getRate() {
-    I2Cdev::readByte(devAddr, MPU6050_RA_SMPLRT_DIV, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::RATE_DIV>(devAddr);
 }
 /** Set gyroscope sample rate divider.
  * @param rate New sample rate divider
@@ -153,7 +214,7 @@ uint8_t MPU6050::getRate() {
  * @see MPU6050_RA_SMPLRT_DIV
  */
 void MPU6050::setRate(uint8_t rate) {
-    I2Cdev::writeByte(devAddr, MPU6050_RA_SMPLRT_DIV, rate);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::RATE_DIV>(rate));
 }
 
 // CONFIG register
@@ -186,8 +247,7 @@ void MPU6050::setRate(uint8_t rate) {
  * @return FSYNC configuration value
  */
 uint8_t MPU6050::getExternalFrameSync() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::EXT_SYNC_SET>(devAddr);
 }
 /** Set external FSYNC configuration.
  * @see getExternalFrameSync()
@@ -195,7 +255,7 @@ uint8_t MPU6050::getExternalFrameSync() {
  * @param sync New FSYNC configuration value
  */
 void MPU6050::setExternalFrameSync(uint8_t sync) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH, sync);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::EXT_SYNC_SET>(sync));
 }
 /** Get digital low-pass filter configuration.
  * The DLPF_CFG parameter sets the digital low pass filter configuration. It
@@ -226,8 +286,7 @@ void MPU6050::setExternalFrameSync(uint8_t sync) {
  * @see MPU6050_CFG_DLPF_CFG_LENGTH
  */
 uint8_t MPU6050::getDLPFMode() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::DLPF_CFG>(devAddr);
 }
 /** Set digital low-pass filter configuration.
  * @param mode New DLFP configuration setting
@@ -238,7 +297,7 @@ uint8_t MPU6050::getDLPFMode() {
  * @see MPU6050_CFG_DLPF_CFG_LENGTH
  */
 void MPU6050::setDLPFMode(uint8_t mode) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH, mode);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::DLPF_CFG>(mode));
 }
 
 // GYRO_CONFIG register
@@ -261,8 +320,7 @@ void MPU6050::setDLPFMode(uint8_t mode) {
  * @see MPU6050_GCONFIG_FS_SEL_LENGTH
  */
 uint8_t MPU6050::getFullScaleGyroRange() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::FS_SEL>(devAddr);
 }
 /** Set full-scale gyroscope range.
  * @param range New full-scale gyroscope range value
@@ -273,7 +331,7 @@ uint8_t MPU6050::getFullScaleGyroRange() {
  * @see MPU6050_GCONFIG_FS_SEL_LENGTH
  */
 void MPU6050::setFullScaleGyroRange(uint8_t range) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH, range);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::FS_SEL>(range));
 }
 
 // SELF TEST FACTORY TRIM VALUES
@@ -341,45 +399,42 @@ uint8_t MPU6050::getGyroZSelfTestFactoryTrim() {
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 bool MPU6050::getAccelXSelfTest() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::XA_ST>(devAddr);
 }
 /** Get self-test enabled setting for accelerometer X axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 void MPU6050::setAccelXSelfTest(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::XA_ST>(enabled));
 }
 /** Get self-test enabled value for accelerometer Y axis.
  * @return Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 bool MPU6050::getAccelYSelfTest() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::YA_ST>(devAddr);
 }
 /** Get self-test enabled value for accelerometer Y axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 void MPU6050::setAccelYSelfTest(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::YA_ST>(enabled));
 }
 /** Get self-test enabled value for accelerometer Z axis.
  * @return Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 bool MPU6050::getAccelZSelfTest() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::ZA_ST>(devAddr);
 }
 /** Set self-test enabled value for accelerometer Z axis.
  * @param enabled Self-test enabled value
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 void MPU6050::setAccelZSelfTest(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::ZA_ST>(enabled));
 }
 /** Get full-scale accelerometer range.
  * The FS_SEL parameter allows setting the full-scale range of the accelerometer
@@ -399,15 +454,14 @@ void MPU6050::setAccelZSelfTest(bool enabled) {
  * @see MPU6050_ACONFIG_AFS_SEL_LENGTH
  */
 uint8_t MPU6050::getFullScaleAccelRange() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::AFS_SEL>(devAddr);
 }
 /** Set full-scale accelerometer range.
  * @param range New full-scale accelerometer range setting
  * @see getFullScaleAccelRange()
  */
 void MPU6050::setFullScaleAccelRange(uint8_t range) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH, range);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::AFS_SEL>(range));
 }
 /** Get the high-pass filter configuration.
  * The DHPF is a filter module in the path leading to motion detectors (Free
@@ -445,8 +499,7 @@ void MPU6050::setFullScaleAccelRange(uint8_t range) {
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 uint8_t MPU6050::getDHPFMode() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::ACCEL_HPF>(devAddr);
 }
 /** Set the high-pass filter configuration.
  * @param bandwidth New high-pass filter configuration
@@ -455,7 +508,7 @@ uint8_t MPU6050::getDHPFMode() {
  * @see MPU6050_RA_ACCEL_CONFIG
  */
 void MPU6050::setDHPFMode(uint8_t bandwidth) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH, bandwidth);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::ACCEL_HPF>(bandwidth));
 }
 
 // FF_THR register
@@ -1724,12 +1777,13 @@ bool MPU6050::getIntFreefallStatus() {
 /** Get Motion Detection interrupt status.
  * This bit automatically sets to 1 when a Motion Detection interrupt has been
  * generated. The bit clears to 0 after the register has been read.
- * @return Current interrupt status
+ * @return Current interrupt status, false on bus error (the next read retries)
  * @see MPU6050_RA_INT_STATUS
  * @see MPU6050_INTERRUPT_MOT_BIT
  */
 bool MPU6050::getIntMotionStatus() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_MOT_BIT, buffer);
+    if (I2Cdev::readBit(devAddr, MPU6050_RA_INT_STATUS, MPU6050_INTERRUPT_MOT_BIT, buffer) != 1)
+        return false;
     return buffer[0];
 }
 /** Get Zero Motion Detection interrupt status.
@@ -1808,18 +1862,41 @@ void MPU6050::getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int
  * @param gx 16-bit signed integer container for gyroscope X-axis value
  * @param gy 16-bit signed integer container for gyroscope Y-axis value
  * @param gz 16-bit signed integer container for gyroscope Z-axis value
+ * @return Status of read operation (true = success, containers are left unchanged otherwise)
  * @see getAcceleration()
  * @see getRotation()
  * @see MPU6050_RA_ACCEL_XOUT_H
  */
-void MPU6050::getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz) {
-    I2Cdev::readBytes(devAddr, MPU6050_RA_ACCEL_XOUT_H, 14, buffer);
+bool MPU6050::getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz) {
+    if (I2Cdev::readBytes(devAddr, MPU6050_RA_ACCEL_XOUT_H, 14, buffer) != 14)
+        return false;
     *ax = (((int16_t)buffer[0]) << 8) | buffer[1];
     *ay = (((int16_t)buffer[2]) << 8) | buffer[3];
     *az = (((int16_t)buffer[4]) << 8) | buffer[5];
     *gx = (((int16_t)buffer[8]) << 8) | buffer[9];
     *gy = (((int16_t)buffer[10]) << 8) | buffer[11];
     *gz = (((int16_t)buffer[12]) << 8) | buffer[13];
+    return true;
+}
+/** Get raw 6-axis motion sensor readings and the die temperature.
+ * TEMP_OUT lies between the accelerometer and gyroscope outputs, it comes
+ * with the same 14-byte burst as getMotion6() at no extra bus cost.
+ * @param ax 16-bit signed integer container for accelerometer X-axis value
+ * @param ay 16-bit signed integer container for accelerometer Y-axis value
+ * @param az 16-bit signed integer container for accelerometer Z-axis value
+ * @param gx 16-bit signed integer container for gyroscope X-axis value
+ * @param gy 16-bit signed integer container for gyroscope Y-axis value
+ * @param gz 16-bit signed integer container for gyroscope Z-axis value
+ * @param t 16-bit signed integer container for temperature value (see getTemperature())
+ * @return Status of read operation (true = success, containers are left unchanged otherwise)
+ * @see getMotion6()
+ * @see getTemperature()
+ */
+bool MPU6050::getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* t) {
+    if (!getMotion6(ax, ay, az, gx, gy, gz))
+        return false;
+    *t = (((int16_t)buffer[6]) << 8) | buffer[7];
+    return true;
 }
 /** Get 3-axis accelerometer readings.
  * These registers store the most recent accelerometer measurements.
@@ -2446,7 +2523,8 @@ void MPU6050::resetSensors() {
  * @see MPU6050_PWR1_DEVICE_RESET_BIT
  */
 void MPU6050::reset() {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_DEVICE_RESET_BIT, true);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::DEVICE_RESET>(true));
+    I2Cdev::invalidateShadow(devAddr);
 }
 /** Get sleep mode status.
  * Setting the SLEEP bit in the register puts the device into very low power
@@ -2460,8 +2538,7 @@ void MPU6050::reset() {
  * @see MPU6050_PWR1_SLEEP_BIT
  */
 bool MPU6050::getSleepEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::SLEEP>(devAddr);
 }
 /** Set sleep mode status.
  * @param enabled New sleep mode enabled status
@@ -2470,7 +2547,7 @@ bool MPU6050::getSleepEnabled() {
  * @see MPU6050_PWR1_SLEEP_BIT
  */
 void MPU6050::setSleepEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::SLEEP>(enabled));
 }
 /** Get wake cycle enabled status.
  * When this bit is set to 1 and SLEEP is disabled, the MPU-60X0 will cycle
@@ -2481,8 +2558,7 @@ void MPU6050::setSleepEnabled(bool enabled) {
  * @see MPU6050_PWR1_CYCLE_BIT
  */
 bool MPU6050::getWakeCycleEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::CYCLE>(devAddr);
 }
 /** Set wake cycle enabled status.
  * @param enabled New sleep mode enabled status
@@ -2491,7 +2567,7 @@ bool MPU6050::getWakeCycleEnabled() {
  * @see MPU6050_PWR1_CYCLE_BIT
  */
 void MPU6050::setWakeCycleEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::CYCLE>(enabled));
 }
 /** Get temperature sensor enabled status.
  * Control the usage of the internal temperature sensor.
@@ -2505,8 +2581,7 @@ void MPU6050::setWakeCycleEnabled(bool enabled) {
  * @see MPU6050_PWR1_TEMP_DIS_BIT
  */
 bool MPU6050::getTempSensorEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, buffer);
-    return buffer[0] == 0; // 1 is actually disabled here
+    return !I2CdevRegister::get<MPU6050_Reg::TEMP_DIS>(devAddr); // 1 is actually disabled here
 }
 /** Set temperature sensor enabled status.
  * Note: this register stores the *disabled* value, but for consistency with the
@@ -2520,7 +2595,7 @@ bool MPU6050::getTempSensorEnabled() {
  */
 void MPU6050::setTempSensorEnabled(bool enabled) {
     // 1 is actually disabled here
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT, !enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::TEMP_DIS>(!enabled));
 }
 /** Get clock source setting.
  * @return Current clock source setting
@@ -2529,8 +2604,7 @@ void MPU6050::setTempSensorEnabled(bool enabled) {
  * @see MPU6050_PWR1_CLKSEL_LENGTH
  */
 uint8_t MPU6050::getClockSource() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::CLKSEL>(devAddr);
 }
 /** Set clock source setting.
  * An internal 8MHz oscillator, gyroscope based clock, or external sources can
@@ -2563,7 +2637,7 @@ uint8_t MPU6050::getClockSource() {
  * @see MPU6050_PWR1_CLKSEL_LENGTH
  */
 void MPU6050::setClockSource(uint8_t source) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH, source);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::CLKSEL>(source));
 }
 
 // PWR_MGMT_2 register
@@ -2592,15 +2666,14 @@ void MPU6050::setClockSource(uint8_t source) {
  * @see MPU6050_RA_PWR_MGMT_2
  */
 uint8_t MPU6050::getWakeFrequency() {
-    I2Cdev::readBits(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::LP_WAKE_CTRL>(devAddr);
 }
 /** Set wake frequency in Accel-Only Low Power Mode.
  * @param frequency New wake frequency
  * @see MPU6050_RA_PWR_MGMT_2
  */
 void MPU6050::setWakeFrequency(uint8_t frequency) {
-    I2Cdev::writeBits(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH, frequency);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::LP_WAKE_CTRL>(frequency));
 }
 
 /** Get X-axis accelerometer standby enabled status.
@@ -2610,8 +2683,7 @@ void MPU6050::setWakeFrequency(uint8_t frequency) {
  * @see MPU6050_PWR2_STBY_XA_BIT
  */
 bool MPU6050::getStandbyXAccelEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_XA>(devAddr);
 }
 /** Set X-axis accelerometer standby enabled status.
  * @param New X-axis standby enabled status
@@ -2620,7 +2692,7 @@ bool MPU6050::getStandbyXAccelEnabled() {
  * @see MPU6050_PWR2_STBY_XA_BIT
  */
 void MPU6050::setStandbyXAccelEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_XA>(enabled));
 }
 /** Get Y-axis accelerometer standby enabled status.
  * If enabled, the Y-axis will not gather or report data (or use power).
@@ -2629,8 +2701,7 @@ void MPU6050::setStandbyXAccelEnabled(bool enabled) {
  * @see MPU6050_PWR2_STBY_YA_BIT
  */
 bool MPU6050::getStandbyYAccelEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_YA>(devAddr);
 }
 /** Set Y-axis accelerometer standby enabled status.
  * @param New Y-axis standby enabled status
@@ -2639,7 +2710,7 @@ bool MPU6050::getStandbyYAccelEnabled() {
  * @see MPU6050_PWR2_STBY_YA_BIT
  */
 void MPU6050::setStandbyYAccelEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_YA>(enabled));
 }
 /** Get Z-axis accelerometer standby enabled status.
  * If enabled, the Z-axis will not gather or report data (or use power).
@@ -2648,8 +2719,7 @@ void MPU6050::setStandbyYAccelEnabled(bool enabled) {
  * @see MPU6050_PWR2_STBY_ZA_BIT
  */
 bool MPU6050::getStandbyZAccelEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_ZA>(devAddr);
 }
 /** Set Z-axis accelerometer standby enabled status.
  * @param New Z-axis standby enabled status
@@ -2658,7 +2728,7 @@ bool MPU6050::getStandbyZAccelEnabled() {
  * @see MPU6050_PWR2_STBY_ZA_BIT
  */
 void MPU6050::setStandbyZAccelEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_ZA>(enabled));
 }
 /** Get X-axis gyroscope standby enabled status.
  * If enabled, the X-axis will not gather or report data (or use power).
@@ -2667,8 +2737,7 @@ void MPU6050::setStandbyZAccelEnabled(bool enabled) {
  * @see MPU6050_PWR2_STBY_XG_BIT
  */
 bool MPU6050::getStandbyXGyroEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_XG>(devAddr);
 }
 /** Set X-axis gyroscope standby enabled status.
  * @param New X-axis standby enabled status
@@ -2677,7 +2746,7 @@ bool MPU6050::getStandbyXGyroEnabled() {
  * @see MPU6050_PWR2_STBY_XG_BIT
  */
 void MPU6050::setStandbyXGyroEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_XG>(enabled));
 }
 /** Get Y-axis gyroscope standby enabled status.
  * If enabled, the Y-axis will not gather or report data (or use power).
@@ -2686,8 +2755,7 @@ void MPU6050::setStandbyXGyroEnabled(bool enabled) {
  * @see MPU6050_PWR2_STBY_YG_BIT
  */
 bool MPU6050::getStandbyYGyroEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_YG>(devAddr);
 }
 /** Set Y-axis gyroscope standby enabled status.
  * @param New Y-axis standby enabled status
@@ -2696,7 +2764,7 @@ bool MPU6050::getStandbyYGyroEnabled() {
  * @see MPU6050_PWR2_STBY_YG_BIT
  */
 void MPU6050::setStandbyYGyroEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_YG>(enabled));
 }
 /** Get Z-axis gyroscope standby enabled status.
  * If enabled, the Z-axis will not gather or report data (or use power).
@@ -2705,8 +2773,7 @@ void MPU6050::setStandbyYGyroEnabled(bool enabled) {
  * @see MPU6050_PWR2_STBY_ZG_BIT
  */
 bool MPU6050::getStandbyZGyroEnabled() {
-    I2Cdev::readBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, buffer);
-    return buffer[0];
+    return I2CdevRegister::get<MPU6050_Reg::STBY_ZG>(devAddr);
 }
 /** Set Z-axis gyroscope standby enabled status.
  * @param New Z-axis standby enabled status
@@ -2715,7 +2782,7 @@ bool MPU6050::getStandbyZGyroEnabled() {
  * @see MPU6050_PWR2_STBY_ZG_BIT
  */
 void MPU6050::setStandbyZGyroEnabled(bool enabled) {
-    I2Cdev::writeBit(devAddr, MPU6050_RA_PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT, enabled);
+    I2CdevRegister::write(devAddr, I2CdevRegister::set<MPU6050_Reg::STBY_ZG>(enabled));
 }
 
 // FIFO_COUNT* registers
@@ -2731,6 +2798,17 @@ uint16_t MPU6050::getFIFOCount() {
     I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_COUNTH, 2, buffer);
     return (((uint16_t)buffer[0]) << 8) | buffer[1];
 }
+/** Get current FIFO buffer size, with the status of the read.
+ * @param count Container for the FIFO buffer size, left unchanged on bus error
+ * @return Status of read operation (true = success)
+ * @see getFIFOCount()
+ */
+bool MPU6050::getFIFOCount(uint16_t *count) {
+    if (I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_COUNTH, 2, buffer) != 2)
+        return false;
+    *count = (((uint16_t)buffer[0]) << 8) | buffer[1];
+    return true;
+}
 
 // FIFO_R_W register
 
@@ -2763,12 +2841,19 @@ uint8_t MPU6050::getFIFOByte() {
     I2Cdev::readByte(devAddr, MPU6050_RA_FIFO_R_W, buffer);
     return buffer[0];
 }
-void MPU6050::getFIFOBytes(uint8_t *data, uint8_t length) {
+/** Get bytes from FIFO buffer.
+ * @param data Buffer to store the bytes in
+ * @param length Number of bytes to read
+ * @return Status of read operation (true = success, data content is undefined otherwise)
+ * @see getFIFOByte()
+ */
+bool MPU6050::getFIFOBytes(uint8_t *data, uint8_t length) {
     if(length > 0){
-        I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_R_W, length, data);
+        return I2Cdev::readBytes(devAddr, MPU6050_RA_FIFO_R_W, length, data) == length;
     } else {
     	*data = 0;
     }
+    return true;
 }
 /** Write byte to FIFO buffer.
  * @see getFIFOByte()
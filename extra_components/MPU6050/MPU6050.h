@@ -442,6 +442,9 @@ class MPU6050 {
 
         void initialize();
         bool testConnection();
+        bool setRegisterShadowEnabled(bool enabled);
+        bool setAcquisitionConfig(uint8_t rateDiv, uint8_t dlpfMode, uint8_t gyroRange, uint8_t accelRange);
+        bool setLowPowerAccelMode(bool enabled, uint8_t wakeFrequency);
 
         // AUX_VDDIO register
         uint8_t getAuxVDDIOLevel();
@@ -623,7 +626,8 @@ class MPU6050 {
 
         // ACCEL_*OUT_* registers
         void getMotion9(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* mx, int16_t* my, int16_t* mz);
-        void getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz);
+        bool getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz);
+        bool getMotion6(int16_t* ax, int16_t* ay, int16_t* az, int16_t* gx, int16_t* gy, int16_t* gz, int16_t* t);
         void getAcceleration(int16_t* x, int16_t* y, int16_t* z);
         int16_t getAccelerationX();
         int16_t getAccelerationY();
@@ -714,11 +718,12 @@ class MPU6050 {
 
         // FIFO_COUNT_* registers
         uint16_t getFIFOCount();
+        bool getFIFOCount(uint16_t *count);
 
         // FIFO_R_W register
         uint8_t getFIFOByte();
         void setFIFOByte(uint8_t data);
-        void getFIFOBytes(uint8_t *data, uint8_t length);
+        bool getFIFOBytes(uint8_t *data, uint8_t length);
 
         // WHO_AM_I register
         uint8_t getDeviceID();
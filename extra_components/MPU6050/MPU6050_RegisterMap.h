@@ -0,0 +1,86 @@
+// I2Cdev library collection - MPU6050 typed register map
+// Based on InvenSense MPU-6050 register map document rev. 2.0, 5/19/2011 (RM-MPU-6000A-00)
+//
+// Changelog:
+//      2026-10-18 - Initial release, configuration and power management registers
+
+/* ============================================
+I2Cdev device library code is placed under the MIT license
+Copyright (c) 2012 Jeff Rowberg
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+#ifndef _MPU6050_REGISTER_MAP_H_
+#define _MPU6050_REGISTER_MAP_H_
+
+#include "I2CdevRegister.h"
+#include "MPU6050.h"
+
+// Field descriptions are built from the MPU6050_*_BIT / *_LENGTH defines of
+// MPU6050.h, so both stay in sync. See I2CdevRegister.h for the write() rules.
+
+namespace MPU6050_Reg {
+
+    using I2CdevRegister::Register;
+    using I2CdevRegister::Field;
+    using I2CdevRegister::Flag;
+
+    // SMPLRT_DIV register
+    typedef Register<MPU6050_RA_SMPLRT_DIV> SMPLRT_DIV;
+    typedef Field<SMPLRT_DIV, 7, 8> RATE_DIV;
+
+    // CONFIG register
+    typedef Register<MPU6050_RA_CONFIG> CONFIG;
+    typedef Field<CONFIG, MPU6050_CFG_EXT_SYNC_SET_BIT, MPU6050_CFG_EXT_SYNC_SET_LENGTH> EXT_SYNC_SET;
+    typedef Field<CONFIG, MPU6050_CFG_DLPF_CFG_BIT, MPU6050_CFG_DLPF_CFG_LENGTH> DLPF_CFG;
+
+    // GYRO_CONFIG register
+    typedef Register<MPU6050_RA_GYRO_CONFIG> GYRO_CONFIG;
+    typedef Field<GYRO_CONFIG, MPU6050_GCONFIG_FS_SEL_BIT, MPU6050_GCONFIG_FS_SEL_LENGTH> FS_SEL;
+
+    // ACCEL_CONFIG register
+    typedef Register<MPU6050_RA_ACCEL_CONFIG> ACCEL_CONFIG;
+    typedef Flag<ACCEL_CONFIG, MPU6050_ACONFIG_XA_ST_BIT> XA_ST;
+    typedef Flag<ACCEL_CONFIG, MPU6050_ACONFIG_YA_ST_BIT> YA_ST;
+    typedef Flag<ACCEL_CONFIG, MPU6050_ACONFIG_ZA_ST_BIT> ZA_ST;
+    typedef Field<ACCEL_CONFIG, MPU6050_ACONFIG_AFS_SEL_BIT, MPU6050_ACONFIG_AFS_SEL_LENGTH> AFS_SEL;
+    typedef Field<ACCEL_CONFIG, MPU6050_ACONFIG_ACCEL_HPF_BIT, MPU6050_ACONFIG_ACCEL_HPF_LENGTH> ACCEL_HPF;
+
+    // PWR_MGMT_1 register
+    typedef Register<MPU6050_RA_PWR_MGMT_1> PWR_MGMT_1;
+    typedef Flag<PWR_MGMT_1, MPU6050_PWR1_DEVICE_RESET_BIT> DEVICE_RESET;
+    typedef Flag<PWR_MGMT_1, MPU6050_PWR1_SLEEP_BIT> SLEEP;
+    typedef Flag<PWR_MGMT_1, MPU6050_PWR1_CYCLE_BIT> CYCLE;
+    typedef Flag<PWR_MGMT_1, MPU6050_PWR1_TEMP_DIS_BIT> TEMP_DIS;
+    typedef Field<PWR_MGMT_1, MPU6050_PWR1_CLKSEL_BIT, MPU6050_PWR1_CLKSEL_LENGTH> CLKSEL;
+
+    // PWR_MGMT_2 register
+    typedef Register<MPU6050_RA_PWR_MGMT_2> PWR_MGMT_2;
+    typedef Field<PWR_MGMT_2, MPU6050_PWR2_LP_WAKE_CTRL_BIT, MPU6050_PWR2_LP_WAKE_CTRL_LENGTH> LP_WAKE_CTRL;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_XA_BIT> STBY_XA;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_YA_BIT> STBY_YA;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_ZA_BIT> STBY_ZA;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_XG_BIT> STBY_XG;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_YG_BIT> STBY_YG;
+    typedef Flag<PWR_MGMT_2, MPU6050_PWR2_STBY_ZG_BIT> STBY_ZG;
+}
+
+#endif /* _MPU6050_REGISTER_MAP_H_ */
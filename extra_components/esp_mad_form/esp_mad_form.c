@@ -0,0 +1,251 @@
+/**
+ * @file      esp_mad_form.c
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     application/x-www-form-urlencoded decoder, body or query string
+ *
+ * @details   The text is never modified nor copied : the names are decoded while they are compared,
+ *            a value is decoded into a small buffer of the getter (numbers) or of the caller (string).
+ *            '+' stands for a space and %XX for a byte, a '%' without two hex digits is kept as is.
+ *            When a name appears several times, the first one is used.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <string.h>
+#include <stdlib.h>
+#include "esp_mad_form.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define FORM_NUMBER_MAX     24              /* longest number value converted                     */
+
+/**
+ *	@fn 		static int form_hex(char c)
+ *  @brief		Value of a hex digit
+ *	@param[in]	c : character
+ *	@return		0 to 15, -1 if c is not a hex digit
+ *
+ */
+static int form_hex(char c)
+{
+	if(c >= '0' && c <= '9')
+		return c - '0';
+	if(c >= 'a' && c <= 'f')
+		return c - 'a' + 10;
+	if(c >= 'A' && c <= 'F')
+		return c - 'A' + 10;
+	return -1;
+
+} /* End form_hex() */
+
+/**
+ *	@fn 		static char form_decode(const char **p, const char *end)
+ *  @brief		Decodes one character and moves *p past it
+ *	@param[in]	p : position in the encoded text, end : end of the name or value
+ *	@return		decoded character
+ *
+ */
+static char form_decode(const char **p, const char *end)
+{
+	char c = *(*p)++;
+
+	if(c == '+')
+		return ' ';
+	if(c == '%' && end - *p >= 2){
+		int hi = form_hex((*p)[0]);
+		int lo = form_hex((*p)[1]);
+		if(hi >= 0 && lo >= 0){
+			*p += 2;
+			return (char)(hi << 4 | lo);
+		}
+	}
+	return c;
+
+} /* End form_decode() */
+
+/**
+ *	@fn 		void form_init(form_t *form, const char *data, size_t len)
+ *  @brief		Form on a received body
+ *	@param[in]	form : decoder, data / len : encoded body
+ *	@return		void
+ *
+ */
+void form_init(form_t *form, const char *data, size_t len)
+{
+	form->data = data;
+	form->len = len;
+
+} /* End form_init() */
+
+/**
+ *	@fn 		void form_init_query(form_t *form, const char *uri)
+ *  @brief		Form on the query string of an uri, empty without '?'
+ *	@param[in]	form : decoder, uri : '\0' terminated uri, e.g. "/chord?chordValue=60"
+ *	@return		void
+ *
+ */
+void form_init_query(form_t *form, const char *uri)
+{
+	const char *query = strchr(uri, '?');
+
+	if(query == NULL){
+		form_init(form, uri, 0);
+		return;
+	}
+	query++;
+	form_init(form, query, strcspn(query, "#"));
+
+} /* End form_init_query() */
+
+/**
+ *	@fn 		bool form_find(const form_t *form, const char *key, const char **value, size_t *len)
+ *  @brief		Encoded value of a field
+ *	@param[in]	form : decoder, key : field name (decoded), value / len : value, still encoded
+ *	@return		true if the field is present, "name" alone gives an empty value
+ *
+ */
+bool form_find(const form_t *form, const char *key, const char **value, size_t *len)
+{
+	const char *p = form->data;
+	const char *end = form->data + form->len;
+
+	while(p < end){
+		const char *pair = p;
+		const char *pairEnd = memchr(p, '&', end - p);
+		if(pairEnd == NULL)
+			pairEnd = end;
+		const char *nameEnd = memchr(pair, '=', pairEnd - pair);
+		if(nameEnd == NULL)
+			nameEnd = pairEnd;
+
+		/*--- Decoded name against key ---*/
+		const char *k = key;
+		const char *q = pair;
+		while(q < nameEnd && *k != '\0' && form_decode(&q, nameEnd) == *k)
+			k++;
+		if(q == nameEnd && *k == '\0' && nameEnd > pair){
+			*value = nameEnd < pairEnd ? nameEnd + 1 : pairEnd;
+			*len = pairEnd - *value;
+			return true;
+		}
+
+		p = pairEnd + 1;
+	}
+	return false;
+
+} /* End form_find() */
+
+/**
+ *	@fn 		bool form_get_string(const form_t *form, const char *key, char *out, size_t size)
+ *  @brief		Decoded value of a field, '\0' terminated
+ *	@param[in]	form : decoder, key : field name, out / size : destination
+ *	@return		true if the field is present and its value fits in out
+ *
+ */
+bool form_get_string(const form_t *form, const char *key, char *out, size_t size)
+{
+	const char *value;
+	size_t len;
+	size_t n = 0;
+
+	if(size == 0 || !form_find(form, key, &value, &len))
+		return false;
+
+	const char *end = value + len;
+	while(value < end){
+		if(n + 1 >= size)
+			return false;
+		out[n++] = form_decode(&value, end);
+	}
+	out[n] = '\0';
+	return true;
+
+} /* End form_get_string() */
+
+/**
+ *	@fn 		bool form_get_int(const form_t *form, const char *key, int32_t min, int32_t max, int32_t *out)
+ *  @brief		Decimal integer field, e.g. chordValue=60
+ *	@param[in]	form : decoder, key : field name, min / max : allowed range, out : value, unchanged on failure
+ *	@return		true if the field is an integer within [min, max]
+ *
+ */
+bool form_get_int(const form_t *form, const char *key, int32_t min, int32_t max, int32_t *out)
+{
+	char number[FORM_NUMBER_MAX + 1];
+	const char *s = number;
+	int64_t value = 0;
+
+	if(!form_get_string(form, key, number, sizeof(number)))
+		return false;
+
+	bool negative = (*s == '-');
+	if(negative || *s == '+')
+		s++;
+	if(*s == '\0')
+		return false;
+	for(; *s != '\0'; s++){
+		if(*s < '0' || *s > '9')
+			return false;
+		value = value * 10 + (*s - '0');
+		if(value > (int64_t)INT32_MAX + 1)
+			return false;
+	}
+	if(negative)
+		value = -value;
+	if(value < min || value > max)
+		return false;
+	*out = (int32_t)value;
+	return true;
+
+} /* End form_get_int() */
+
+/**
+ *	@fn 		bool form_get_float(const form_t *form, const char *key, float min, float max, float *out)
+ *  @brief		Decimal number field, e.g. targetAngle=-2.5
+ *	@param[in]	form : decoder, key : field name, min / max : allowed range, out : value, unchanged on failure
+ *	@return		true if the field is a number within [min, max]
+ *
+ */
+bool form_get_float(const form_t *form, const char *key, float min, float max, float *out)
+{
+	char number[FORM_NUMBER_MAX + 1];
+	char *end;
+
+	if(!form_get_string(form, key, number, sizeof(number)) || number[0] == '\0')
+		return false;
+
+	float value = strtof(number, &end);
+	if(*end != '\0' || !(value >= min && value <= max))
+		return false;
+	*out = value;
+	return true;
+
+} /* End form_get_float() */
+
+/**
+ *	@fn 		bool form_get_bool(const form_t *form, const char *key, bool *out)
+ *  @brief		Boolean field : 1 / true / on or 0 / false / off
+ *	@param[in]	form : decoder, key : field name, out : value, unchanged on failure
+ *	@return		true if the field is a boolean
+ *
+ */
+bool form_get_bool(const form_t *form, const char *key, bool *out)
+{
+	char text[8];
+
+	if(!form_get_string(form, key, text, sizeof(text)))
+		return false;
+
+	if(strcmp(text, "1") == 0 || strcmp(text, "true") == 0 || strcmp(text, "on") == 0)
+		*out = true;
+	else if(strcmp(text, "0") == 0 || strcmp(text, "false") == 0 || strcmp(text, "off") == 0)
+		*out = false;
+	else
+		return false;
+	return true;
+
+} /* End form_get_bool() */
@@ -0,0 +1,53 @@
+/**
+ * @file      esp_mad_form.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the esp_mad_form component, application/x-www-form-urlencoded decoder.
+ *
+ * @details   Zero-copy : a form_t only points to the body or to the query string of the uri
+ *            ("name=value&name=value"), the names and values are percent / '+' decoded on the fly
+ *            while they are compared or converted. A lookup is one pass over the text, so its cost
+ *            is bounded by the length of the body. The getters check the bounds of the value.
+ *
+ *            e.g. form_t form;
+ *                 form_init(&form, body, len);
+ *                 if(!form_get_int(&form, "chordValue", 1, 1000, &chord)) ... missing or out of range
+ *
+ */
+
+#ifndef _ESP_MAD_FORM_H_
+
+#define _ESP_MAD_FORM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		const char *data;                   /* encoded text, not '\0' terminated                  */
+		size_t len;
+	} form_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void form_init(form_t *form, const char *data, size_t len);
+	void form_init_query(form_t *form, const char *uri);
+	bool form_find(const form_t *form, const char *key, const char **value, size_t *len);
+	bool form_get_int(const form_t *form, const char *key, int32_t min, int32_t max, int32_t *out);
+	bool form_get_float(const form_t *form, const char *key, float min, float max, float *out);
+	bool form_get_bool(const form_t *form, const char *key, bool *out);
+	bool form_get_string(const form_t *form, const char *key, char *out, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,197 @@
+/**
+ * @file      esp_mad_format.c
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Fixed-decimal formatting of scaled integers into a bounded buffer
+ *
+ * @details   Integer arithmetic only, except fmt_scale() which does one float multiply to bring a
+ *            float measure to its scaled integer. Decimal digits are produced by repeated division
+ *            by 10 into a small stack buffer, then copied.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include "esp_mad_format.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+static const int32_t powers10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+
+#define FMT_MAX_DECIMALS    (sizeof(powers10) / sizeof(powers10[0]) - 1)
+
+/**
+ *	@fn 		void fmt_init(fmt_buf_t *f, char *buf, size_t size)
+ *  @brief		Starts an empty text in buf
+ *	@param[in]	f : formatter, buf / size : destination, '\0' included
+ *	@return		void
+ *
+ */
+void fmt_init(fmt_buf_t *f, char *buf, size_t size)
+{
+	f->buf = buf;
+	f->size = size;
+	f->len = 0;
+	f->overflow = (size == 0);
+	if(size > 0)
+		buf[0] = '\0';
+
+} /* End fmt_init() */
+
+/**
+ *	@fn 		void fmt_char(fmt_buf_t *f, char c)
+ *  @brief		Appends one character
+ *	@param[in]	f : formatter, c : character
+ *	@return		void
+ *
+ */
+void fmt_char(fmt_buf_t *f, char c)
+{
+	if(f->len + 1 >= f->size){
+		f->overflow = true;
+		return;
+	}
+	f->buf[f->len++] = c;
+	f->buf[f->len] = '\0';
+
+} /* End fmt_char() */
+
+/**
+ *	@fn 		void fmt_str(fmt_buf_t *f, const char *s)
+ *  @brief		Appends a string, as is (no JSON escaping)
+ *	@param[in]	f : formatter, s : string
+ *	@return		void
+ *
+ */
+void fmt_str(fmt_buf_t *f, const char *s)
+{
+	while(*s != '\0' && !f->overflow)
+		fmt_char(f, *s++);
+
+} /* End fmt_str() */
+
+/**
+ *	@fn 		static void fmt_digits(fmt_buf_t *f, uint32_t value, int minDigits)
+ *  @brief		Appends the decimal digits of value, zero padded to minDigits
+ *	@param[in]	f : formatter, value : unsigned value, minDigits : minimum digit count
+ *	@return		void
+ *
+ */
+static void fmt_digits(fmt_buf_t *f, uint32_t value, int minDigits)
+{
+	char digits[10];
+	int n = 0;
+
+	do{
+		digits[n++] = (char)('0' + value % 10);
+		value /= 10;
+	}while(value != 0 && n < (int)sizeof(digits));
+	while(n < minDigits && n < (int)sizeof(digits))
+		digits[n++] = '0';
+
+	while(n > 0)
+		fmt_char(f, digits[--n]);
+
+} /* End fmt_digits() */
+
+/**
+ *	@fn 		void fmt_int(fmt_buf_t *f, int32_t value)
+ *  @brief		Appends a signed integer
+ *	@param[in]	f : formatter, value : integer
+ *	@return		void
+ *
+ */
+void fmt_int(fmt_buf_t *f, int32_t value)
+{
+	uint32_t magnitude = (uint32_t)value;
+
+	if(value < 0){
+		fmt_char(f, '-');
+		magnitude = 0u - magnitude;
+	}
+	fmt_digits(f, magnitude, 1);
+
+} /* End fmt_int() */
+
+/**
+ *	@fn 		void fmt_fixed(fmt_buf_t *f, int32_t value, uint8_t decimals)
+ *  @brief		Appends value / 10^decimals with exactly decimals digits after the point,
+ *				e.g. (-5, 2) gives -0.05 and (4180, 3) gives 4.180
+ *	@param[in]	f : formatter, value : scaled integer, decimals : 0 to 6
+ *	@return		void
+ *
+ */
+void fmt_fixed(fmt_buf_t *f, int32_t value, uint8_t decimals)
+{
+	uint32_t magnitude = (uint32_t)value;
+
+	if(decimals > FMT_MAX_DECIMALS)
+		decimals = FMT_MAX_DECIMALS;
+	if(value < 0){
+		fmt_char(f, '-');
+		magnitude = 0u - magnitude;
+	}
+
+	uint32_t scale = (uint32_t)powers10[decimals];
+	fmt_digits(f, magnitude / scale, 1);
+	if(decimals > 0){
+		fmt_char(f, '.');
+		fmt_digits(f, magnitude % scale, decimals);
+	}
+
+} /* End fmt_fixed() */
+
+/**
+ *	@fn 		void fmt_key(fmt_buf_t *f, const char *key)
+ *  @brief		Appends "key": to a JSON object, preceded by a comma unless it is the first member
+ *	@param[in]	f : formatter, key : member name (no escaping)
+ *	@return		void
+ *
+ */
+void fmt_key(fmt_buf_t *f, const char *key)
+{
+	if(f->len > 0 && f->buf[f->len - 1] != '{')
+		fmt_char(f, ',');
+	fmt_char(f, '"');
+	fmt_str(f, key);
+	fmt_str(f, "\":");
+
+} /* End fmt_key() */
+
+/**
+ *	@fn 		int32_t fmt_scale(float value, uint8_t decimals)
+ *  @brief		Scaled integer of a float, rounded half away from zero, saturated
+ *	@param[in]	value : float, decimals : 0 to 6
+ *	@return		value * 10^decimals
+ *
+ */
+int32_t fmt_scale(float value, uint8_t decimals)
+{
+	if(decimals > FMT_MAX_DECIMALS)
+		decimals = FMT_MAX_DECIMALS;
+
+	float scaled = value * (float)powers10[decimals];
+	if(!(scaled == scaled))
+		return 0;                           /* NaN */
+	if(scaled >= 2147483520.0f)
+		return INT32_MAX;
+	if(scaled <= -2147483520.0f)
+		return -INT32_MAX;
+	return (int32_t)(scaled < 0.0f ? scaled - 0.5f : scaled + 0.5f);
+
+} /* End fmt_scale() */
+
+/**
+ *	@fn 		int fmt_end(fmt_buf_t *f)
+ *  @brief		Length of the text, '\0' terminated in the buffer
+ *	@param[in]	f : formatter
+ *	@return		length, -1 if it was truncated
+ *
+ */
+int fmt_end(fmt_buf_t *f)
+{
+	return f->overflow ? -1 : (int)f->len;
+
+} /* End fmt_end() */
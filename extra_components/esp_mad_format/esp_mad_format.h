@@ -0,0 +1,56 @@
+/**
+ * @file      esp_mad_format.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the esp_mad_format component, fixed-decimal formatting of the payloads.
+ *
+ * @details   The values are rendered from scaled integers (angle in 0.1 or 0.01 degree, voltage in
+ *            mV...) straight into the payload buffer, without the printf float path : the C3 has no
+ *            FPU and "%f" costs thousands of cycles per field. The writes never go past the buffer,
+ *            an overflow is reported once by fmt_end().
+ *
+ *            e.g. fmt_init(&f, buf, sizeof(buf)); fmt_str(&f, "{");
+ *                 fmt_key(&f, "angle"); fmt_fixed(&f, fmt_scale(angle, 1), 1); fmt_str(&f, "}");
+ *                 len = fmt_end(&f);       -> {"angle":-12.3}
+ *
+ */
+
+#ifndef _ESP_MAD_FORMAT_H_
+
+#define _ESP_MAD_FORMAT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		char   *buf;
+		size_t  size;                       /* buffer size, the terminating '\0' included     */
+		size_t  len;                        /* characters written                             */
+		bool    overflow;                   /* something did not fit, the text is truncated   */
+	} fmt_buf_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void    fmt_init(fmt_buf_t *f, char *buf, size_t size);
+	void    fmt_char(fmt_buf_t *f, char c);
+	void    fmt_str(fmt_buf_t *f, const char *s);
+	void    fmt_int(fmt_buf_t *f, int32_t value);
+	void    fmt_fixed(fmt_buf_t *f, int32_t value, uint8_t decimals);
+	void    fmt_key(fmt_buf_t *f, const char *key);
+	int32_t fmt_scale(float value, uint8_t decimals);
+	int     fmt_end(fmt_buf_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,247 @@
+/**
+ * @file      esp_mad_indicator.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Status led and WS2812 target led of both firmwares.
+ *
+ * @details   Status led (BLINK_GPIO) : LEDC pwm at a few Hz, fast while the MPU6050s are calibrated,
+ *            a short flash afterwards. The LEDC timer runs from RC_FAST and is kept alive in light
+ *            sleep, the cpu only changes the frequency and the duty.
+ *            Target led (TARGET_LED_GPIO, WS2812) : one colour and one blink rate per target band,
+ *            as displayed by esp.html (steady, 10 Hz, 5 Hz, 1 Hz). led_strip has no RMT loop mode,
+ *            so each toggle is a single 24 bits RMT frame sent from the FreeRTOS timer task, nothing
+ *            is refreshed while the led is steady.
+ *            Target strip (TARGET_LED_COUNT > 1) : bar graph of the signed deviation, one frame per
+ *            move of the bar end, at most one per sample. Bands and bar in esp_mad_target.h.
+ *            The indicator task blocks on the notifications of the measure task (see
+ *            measure_target_led()) and only changes the patterns.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <esp_log.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/timers.h>
+#include <driver/gpio.h>
+#include <driver/ledc.h>
+#include "led_strip.h"
+#include "sdkconfig.h"
+#include "esp_mad_indicator.h"
+#include "esp_mad_target.h"
+#include "esp_mad_task_measure.h"
+#include <Esp_mad.h>
+#include <Esp_mad_Globals_Variables.h>
+
+/*-----------------------------------------
+ *-            DEFINE
+ *-----------------------------------------*/
+#define STATUS_LEDC_MODE        LEDC_LOW_SPEED_MODE
+#define STATUS_LEDC_TIMER       LEDC_TIMER_0
+#define STATUS_LEDC_CHANNEL     LEDC_CHANNEL_0
+#define STATUS_LEDC_RESOLUTION  LEDC_TIMER_14_BIT       /* RC_FAST / (1024 * 2^14) : ~1.1 Hz minimum */
+
+/*-----------------------------------------
+ *-            LOCAL VARIABLES
+ *-----------------------------------------*/
+static const char *TAG = "indicator";
+
+static led_strip_handle_t strip = NULL;
+static volatile uint8_t targetPattern = TARGET_BAND_OFF;
+
+/**
+ *	@fn 		static bool status_led_init(void)
+ *  @brief		LEDC timer and channel of the status led, calibration pattern
+ *	@param[in]	void
+ *	@return		true if the led is driven
+ *
+ */
+static bool status_led_init(void)
+{
+	ledc_timer_config_t timer = {};
+	timer.speed_mode = STATUS_LEDC_MODE;
+	timer.duty_resolution = STATUS_LEDC_RESOLUTION;
+	timer.timer_num = STATUS_LEDC_TIMER;
+	timer.freq_hz = INDICATOR_STATUS_BUSY_HZ;
+	timer.clk_cfg = LEDC_USE_RC_FAST_CLK;
+
+	esp_err_t err = ledc_timer_config(&timer);
+	if(err != ESP_OK){
+		ESP_LOGE(TAG, "Status led timer : %s", esp_err_to_name(err));
+		return false;
+	}
+
+	ledc_channel_config_t channel = {};
+	channel.gpio_num = BLINK_GPIO;
+	channel.speed_mode = STATUS_LEDC_MODE;
+	channel.channel = STATUS_LEDC_CHANNEL;
+	channel.timer_sel = STATUS_LEDC_TIMER;
+	channel.duty = 1 << (STATUS_LEDC_RESOLUTION - 1);
+	channel.hpoint = 0;
+	channel.sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE;
+
+	err = ledc_channel_config(&channel);
+	if(err != ESP_OK){
+		ESP_LOGE(TAG, "Status led channel : %s", esp_err_to_name(err));
+		return false;
+	}
+	return true;
+
+} /* End status_led_init() */
+
+/**
+ *	@fn 		static void status_led_pattern(bool calibrated)
+ *  @brief		Fast blink while calibrating, short flash once calibrated
+ *	@param[in]	calibrated : g_calibrationState is CALIBRATION_DONE
+ *	@return		void
+ *
+ */
+static void status_led_pattern(bool calibrated)
+{
+	uint32_t max = 1 << STATUS_LEDC_RESOLUTION;
+
+	ledc_set_freq(STATUS_LEDC_MODE, STATUS_LEDC_TIMER, calibrated ? INDICATOR_STATUS_IDLE_HZ : INDICATOR_STATUS_BUSY_HZ);
+	ledc_set_duty(STATUS_LEDC_MODE, STATUS_LEDC_CHANNEL, calibrated ? max * INDICATOR_STATUS_IDLE_DUTY / 100 : max / 2);
+	ledc_update_duty(STATUS_LEDC_MODE, STATUS_LEDC_CHANNEL);
+
+} /* End status_led_pattern() */
+
+/**
+ *	@fn 		static bool target_led_init(void)
+ *  @brief		RMT device of the WS2812 led or strip, switched off
+ *	@param[in]	void
+ *	@return		true if the led is driven
+ *
+ */
+static bool target_led_init(void)
+{
+	led_strip_config_t strip_config = {};
+	strip_config.strip_gpio_num = TARGET_LED_GPIO;
+	strip_config.max_leds = TARGET_LED_COUNT;
+	strip_config.led_model = LED_MODEL_WS2812;
+	strip_config.color_component_format = LED_STRIP_COLOR_COMPONENT_FMT_GRB;
+
+	led_strip_rmt_config_t rmt_config = {};
+	rmt_config.clk_src = RMT_CLK_SRC_DEFAULT;
+	rmt_config.resolution_hz = 10 * 1000 * 1000;
+	rmt_config.mem_block_symbols = 64;
+
+	esp_err_t err = led_strip_new_rmt_device(&strip_config, &rmt_config, &strip);
+	if(err != ESP_OK){
+		ESP_LOGE(TAG, "Failed to init led strip: %s", esp_err_to_name(err));
+		strip = NULL;
+		return false;
+	}
+	led_strip_clear(strip);
+	return true;
+
+} /* End target_led_init() */
+
+/**
+ *	@fn 		static void target_blink_callback(TimerHandle_t timer)
+ *  @brief		Sends the next frame of the target pattern. Every write to the strip is done here,
+ *				the timer stops itself on a steady pattern.
+ *	@param[in]	timer : target blink timer
+ *	@return		void
+ *
+ */
+static void target_blink_callback(TimerHandle_t timer)
+{
+	static uint8_t shown = 0xFF;
+	static bool on = false;
+
+	uint8_t pattern = targetPattern;
+	const target_band_t *p = &targetBands[pattern];
+
+	on = (pattern != shown) ? true : !on;
+	shown = pattern;
+
+	if(on)
+		led_strip_set_pixel(strip, 0, p->r, p->g, p->b);
+	else
+		led_strip_set_pixel(strip, 0, 0, 0, 0);
+	led_strip_refresh(strip);
+
+	if(p->halfPeriodMs == 0)
+		xTimerStop(timer, 0);
+	else if(xTimerGetPeriod(timer) != pdMS_TO_TICKS(p->halfPeriodMs))
+		xTimerChangePeriod(timer, pdMS_TO_TICKS(p->halfPeriodMs), 0);
+
+} /* End target_blink_callback() */
+
+/**
+ *	@fn 		static void target_bar_draw(uint8_t band, int8_t bar)
+ *  @brief		Bar graph : leds from the middle one to the bar end in the colour of the band, one RMT
+ *				frame for the whole strip
+ *	@param[in]	band : target band, TARGET_BAND_OFF clears the strip
+ *	@param[in]	bar : bar end, offset from the middle led (see target_bar())
+ *	@return		void
+ *
+ */
+static void target_bar_draw(uint8_t band, int8_t bar)
+{
+	const target_band_t *p = &targetBands[band];
+	int middle = TARGET_LED_COUNT / 2;
+	int first = bar < 0 ? middle + bar : middle;
+	int last = bar < 0 ? middle : middle + bar;
+
+	for(int i = 0; i < TARGET_LED_COUNT; i++){
+		if(band != TARGET_BAND_OFF && i >= first && i <= last)
+			led_strip_set_pixel(strip, i, p->r, p->g, p->b);
+		else
+			led_strip_set_pixel(strip, i, 0, 0, 0);
+	}
+	led_strip_refresh(strip);
+
+} /* End target_bar_draw() */
+
+/**
+ *	@fn 		void task_indicator(void *ignore)
+ *  @brief		Drives both leds, wakes up only when the band or the calibration state changes
+ *	@param[in]	ignore
+ *	@return		void
+ *
+ */
+void task_indicator(void *ignore)
+{
+	bool status = status_led_init();
+	bool target = target_led_init();
+	TimerHandle_t blink = NULL;
+
+	if(target && TARGET_LED_COUNT == 1)
+		blink = xTimerCreate("target_blink", 1, pdTRUE, NULL, target_blink_callback);
+
+	uint8_t calibration = CALIBRATION_BOOT;
+	uint32_t shown = target_notify_value(TARGET_BAND_OFF, 0);
+
+	/*--- Notified by the measure task (eSetValueWithOverwrite) with the target band and bar, on a ---*/
+	/*--- change of the band, of the bar or of the calibration state only.                        ---*/
+	measure_target_led(xTaskGetCurrentTaskHandle());
+
+	while(1){
+		uint32_t value = shown;
+		xTaskNotifyWait(0, UINT32_MAX, &value, portMAX_DELAY);
+
+		if(status && g_calibrationState != calibration){
+			calibration = g_calibrationState;
+			status_led_pattern(calibration == CALIBRATION_DONE);
+		}
+
+		if(!target || value == shown || target_notify_band(value) >= TARGET_BANDS)
+			continue;
+		shown = value;
+
+		/*--- Bar graph : the frame is sent at once. Single led : the blink timer takes the new ---*/
+		/*--- pattern at the next tick.                                                          ---*/
+		if(blink == NULL)
+			target_bar_draw(target_notify_band(value), target_notify_bar(value));
+		else{
+			targetPattern = target_notify_band(value);
+			xTimerChangePeriod(blink, 1, portMAX_DELAY);
+		}
+	}
+
+} /* End task_indicator() */
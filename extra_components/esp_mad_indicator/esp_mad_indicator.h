@@ -0,0 +1,37 @@
+/**
+ * @file      esp_mad_indicator.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the esp_mad_indicator component, status led and WS2812 target led.
+ *
+ * @details   The blink patterns are generated by the peripherals : LEDC for the status led, one
+ *            RMT frame per toggle for the WS2812. The indicator task only changes the pattern when
+ *            the measure task reports a new target band or calibration state.
+ *
+ */
+
+#ifndef _ESP_MAD_INDICATOR_H_
+
+#define _ESP_MAD_INDICATOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define INDICATOR_STATUS_BUSY_HZ    5       /* status led while the MPU6050s are calibrated, 50 % duty  */
+	#define INDICATOR_STATUS_IDLE_HZ    2       /* status led once calibrated, short flash (LEDC >= ~1.1 Hz) */
+	#define INDICATOR_STATUS_IDLE_DUTY  10      /* percent                                                  */
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void task_indicator(void*);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+/**
+ * @file      esp_mad_target.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Target bands and bar graph of the esp_mad_indicator component.
+ *
+ * @details   Pure constexpr code, no ESP-IDF header : the measure task computes the band and the
+ *            bar position of each sample with it, the indicator task draws them. It builds and is
+ *            checked on the host as well (see the static_assert below).
+ *
+ *            - single WS2812 (TARGET_LED_COUNT 1) : one colour and one blink rate per band.
+ *            - WS2812 bar graph (TARGET_LED_COUNT > 1) : the signed deviation moves a bar from the
+ *              middle led, in the colour of the band, TARGET_BAR_FULL_SCALE at the strip ends.
+ *
+ */
+
+#ifndef _ESP_MAD_TARGET_H_
+
+#define _ESP_MAD_TARGET_H_
+
+#include <stdint.h>
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		float    limit;                     /* |deviation| up to this limit in degree     */
+		uint8_t  r, g, b;
+		uint16_t halfPeriodMs;              /* single led blink, 0 : steady               */
+	} target_band_t;
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	/*--- Indexed by the band, blink rates of esp.html. The last band has no limit. ---*/
+	static constexpr target_band_t targetBands[] = {
+		{ 0.0f,  0,  0,  0,   0 },          /* TARGET_BAND_OFF : no target set            */
+		{ 0.1f,  0, 64,  0,   0 },          /* green  : steady                            */
+		{ 0.5f,  0,  0, 64,  50 },          /* blue   : 10 Hz                             */
+		{ 1.0f,  0, 32, 64, 100 },          /* cyan   : 5 Hz                              */
+		{ 2.0f, 64, 48,  0, 500 },          /* yellow : 1 Hz                              */
+		{ 5.0f, 64, 16,  0, 500 },          /* orange : 1 Hz                              */
+		{ 0.0f, 64,  0,  0, 500 },          /* red    : 1 Hz                              */
+	};
+
+	static constexpr uint8_t TARGET_BANDS = sizeof(targetBands) / sizeof(targetBands[0]);
+	static constexpr float TARGET_BAR_FULL_SCALE = targetBands[TARGET_BANDS - 2].limit;
+
+	/*------------------------------------------
+	 * FUNCTIONS
+	 *------------------------------------------*/
+	/**
+	 *	@brief		Band of a deviation from the target, 1 (green) to TARGET_BANDS - 1 (red)
+	 *	@param[in]	deviation : angle - target in degree, signed
+	 */
+	static constexpr uint8_t target_band(float deviation)
+	{
+		float d = deviation < 0.0f ? -deviation : deviation;
+		uint8_t band = 1;
+
+		while(band < TARGET_BANDS - 1 && d > targetBands[band].limit)
+			band++;
+		return band;
+	}
+
+	/**
+	 *	@brief		Bar end of a deviation on a strip of leds leds, offset from the middle led
+	 *				(leds / 2) : -leds / 2 to (leds - 1) / 2, rounded, clipped at full scale.
+	 *	@param[in]	deviation : angle - target in degree, signed
+	 *	@param[in]	leds : strip length
+	 */
+	static constexpr int8_t target_bar(float deviation, int leds)
+	{
+		int half = leds / 2;
+		float x = deviation / TARGET_BAR_FULL_SCALE * half;
+		int bar = (int)(x < 0.0f ? x - 0.5f : x + 0.5f);
+
+		if(bar < -half)
+			bar = -half;
+		if(bar > leds - 1 - half)
+			bar = leds - 1 - half;
+		return (int8_t)bar;
+	}
+
+	/**
+	 *	@brief		Measure to indicator notification value : band in bits 0-7, bar in bits 8-15
+	 */
+	static constexpr uint32_t target_notify_value(uint8_t band, int8_t bar)
+	{
+		return band | ((uint32_t)(uint8_t)bar << 8);
+	}
+
+	static constexpr uint8_t target_notify_band(uint32_t value) { return (uint8_t)value; }
+	static constexpr int8_t target_notify_bar(uint32_t value) { return (int8_t)(uint8_t)(value >> 8); }
+
+	/*--- Checked by every build ---*/
+	static_assert(target_band(0.0f) == 1 && target_band(-0.1f) == 1, "band limits are inclusive");
+	static_assert(target_band(0.3f) == 2 && target_band(-0.7f) == 3 && target_band(1.5f) == 4, "bands");
+	static_assert(target_band(5.0f) == 5 && target_band(-90.0f) == TARGET_BANDS - 1, "last band");
+	static_assert(target_bar(0.0f, 16) == 0 && target_bar(-99.0f, 16) == -8 && target_bar(99.0f, 16) == 7, "bar");
+	static_assert(target_bar(2.5f, 9) == 2 && target_bar(-2.5f, 9) == -2 && target_bar(1.0f, 1) == 0, "bar");
+	static_assert(target_notify_bar(target_notify_value(3, -5)) == -5 && target_notify_band(target_notify_value(3, -5)) == 3, "notify");
+
+#endif
@@ -0,0 +1,415 @@
+/**
+ * @file      esp_mad_json.c
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     In-place JSON tokenizer and typed getters
+ *
+ * @details   The tokenizer follows jsmn (strict mode, parent links) : one pass, no allocation, the
+ *            tokens point into the body. Strings are not unescaped, json_get_string() only handles
+ *            \" \\ and \/ (the keys and values of the esp_mad requests are plain ASCII).
+ *            Numbers are converted from the token bounds, nothing relies on a '\0' terminated body.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <string.h>
+#include <stdlib.h>
+#include "esp_mad_json.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define JSON_NUMBER_MAX     24              /* longest number token converted                     */
+
+/**
+ *	@fn 		static json_tok_t *json_alloc(json_tok_t *tokens, int *next, int max)
+ *  @brief		Next free token of the array
+ *	@param[in]	tokens : array, next : count of used tokens, max : array size
+ *	@return		token, NULL if the array is full
+ *
+ */
+static json_tok_t *json_alloc(json_tok_t *tokens, int *next, int max)
+{
+	if(*next >= max)
+		return NULL;
+
+	json_tok_t *tok = &tokens[(*next)++];
+	tok->type = JSON_UNDEFINED;
+	tok->start = tok->end = -1;
+	tok->size = 0;
+	tok->parent = -1;
+	return tok;
+
+} /* End json_alloc() */
+
+/**
+ *	@fn 		static int json_primitive(const char *js, size_t len, size_t *pos, ...)
+ *  @brief		Primitive token (number, true, false, null) from *pos, *pos left on its last character
+ *	@param[in]	js / len : body, pos : position, tokens / next / max : token array, parent : enclosing token
+ *	@return		0, JSON_ERROR_xxx
+ *
+ */
+static int json_primitive(const char *js, size_t len, size_t *pos, json_tok_t *tokens, int *next, int max, int parent)
+{
+	size_t start = *pos;
+
+	for(; *pos < len; (*pos)++){
+		char c = js[*pos];
+		if(c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ']' || c == '}' || c == ':')
+			break;
+		if(c < 32 || c >= 127)
+			return JSON_ERROR_INVAL;
+	}
+	if(*pos == len && parent >= 0)
+		return JSON_ERROR_PART;
+
+	json_tok_t *tok = json_alloc(tokens, next, max);
+	if(tok == NULL)
+		return JSON_ERROR_NOMEM;
+	tok->type = JSON_PRIMITIVE;
+	tok->start = (int16_t)start;
+	tok->end = (int16_t)*pos;
+	tok->parent = (int16_t)parent;
+	(*pos)--;
+	return 0;
+
+} /* End json_primitive() */
+
+/**
+ *	@fn 		static int json_string(const char *js, size_t len, size_t *pos, ...)
+ *  @brief		String token from the opening quote at *pos, *pos left on the closing quote
+ *	@param[in]	js / len : body, pos : position, tokens / next / max : token array, parent : enclosing token
+ *	@return		0, JSON_ERROR_xxx
+ *
+ */
+static int json_string(const char *js, size_t len, size_t *pos, json_tok_t *tokens, int *next, int max, int parent)
+{
+	size_t start = *pos;
+
+	for((*pos)++; *pos < len; (*pos)++){
+		char c = js[*pos];
+		if(c == '"'){
+			json_tok_t *tok = json_alloc(tokens, next, max);
+			if(tok == NULL){
+				*pos = start;
+				return JSON_ERROR_NOMEM;
+			}
+			tok->type = JSON_STRING;
+			tok->start = (int16_t)(start + 1);
+			tok->end = (int16_t)*pos;
+			tok->parent = (int16_t)parent;
+			return 0;
+		}
+		if(c == '\\'){
+			if(++(*pos) >= len)
+				break;
+			if(strchr("\"/\\bfrnt", js[*pos]) == NULL && js[*pos] != 'u')
+				return JSON_ERROR_INVAL;
+		}
+	}
+	*pos = start;
+	return JSON_ERROR_PART;
+
+} /* End json_string() */
+
+/**
+ *	@fn 		int json_tokenize(const char *js, size_t len, json_tok_t *tokens, int max)
+ *  @brief		Splits a JSON text into tokens, in order of appearance, the root first
+ *	@param[in]	js / len : body (no '\0' needed), tokens / max : token array
+ *	@return		count of tokens, JSON_ERROR_xxx
+ *
+ */
+int json_tokenize(const char *js, size_t len, json_tok_t *tokens, int max)
+{
+	int next = 0;
+	int super = -1;                         /* innermost open object or array                     */
+	int err;
+
+	if(len > INT16_MAX)
+		return JSON_ERROR_NOMEM;
+
+	for(size_t pos = 0; pos < len; pos++){
+		char c = js[pos];
+		json_tok_t *tok;
+
+		switch(c){
+		case '{':
+		case '[':
+			tok = json_alloc(tokens, &next, max);
+			if(tok == NULL)
+				return JSON_ERROR_NOMEM;
+			if(super >= 0){
+				if(tokens[super].type == JSON_OBJECT)
+					return JSON_ERROR_INVAL;        /* an object key must be a string             */
+				tokens[super].size++;
+				tok->parent = (int16_t)super;
+			}
+			tok->type = (c == '{') ? JSON_OBJECT : JSON_ARRAY;
+			tok->start = (int16_t)pos;
+			super = next - 1;
+			break;
+
+		case '}':
+		case ']':
+			{
+				json_type_t type = (c == '}') ? JSON_OBJECT : JSON_ARRAY;
+				int i = next - 1;
+
+				/*--- Closes the innermost open container, through a key awaiting its value ---*/
+				while(i >= 0 && !(tokens[i].start != -1 && tokens[i].end == -1 && tokens[i].type != JSON_STRING && tokens[i].type != JSON_PRIMITIVE))
+					i = tokens[i].parent;
+				if(i < 0 || tokens[i].type != type)
+					return JSON_ERROR_INVAL;
+				tokens[i].end = (int16_t)(pos + 1);
+				super = tokens[i].parent;
+				if(super >= 0 && tokens[super].type == JSON_STRING)
+					super = tokens[super].parent;
+			}
+			break;
+
+		case '"':
+			err = json_string(js, len, &pos, tokens, &next, max, super);
+			if(err < 0)
+				return err;
+			if(super >= 0)
+				tokens[super].size++;
+			break;
+
+		case ' ':
+		case '\t':
+		case '\r':
+		case '\n':
+			break;
+
+		case ':':
+			/*--- The key becomes the parent of its value ---*/
+			if(next == 0 || tokens[next - 1].type != JSON_STRING || tokens[next - 1].parent != super ||
+			   super < 0 || tokens[super].type != JSON_OBJECT)
+				return JSON_ERROR_INVAL;
+			super = next - 1;
+			break;
+
+		case ',':
+			/*--- Back from the key to its object ---*/
+			if(super >= 0 && tokens[super].type != JSON_ARRAY && tokens[super].type != JSON_OBJECT)
+				super = tokens[super].parent;
+			break;
+
+		case '-': case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+		case 't': case 'f': case 'n':
+			/*--- Strict : a primitive is a value, never a key ---*/
+			if(super >= 0 && tokens[super].type == JSON_OBJECT)
+				return JSON_ERROR_INVAL;
+			err = json_primitive(js, len, &pos, tokens, &next, max, super);
+			if(err < 0)
+				return err;
+			if(super >= 0)
+				tokens[super].size++;
+			break;
+
+		default:
+			return JSON_ERROR_INVAL;
+		}
+	}
+
+	/*--- Every container closed ---*/
+	for(int i = next - 1; i >= 0; i--)
+		if(tokens[i].start != -1 && tokens[i].end == -1)
+			return JSON_ERROR_PART;
+
+	return next;
+
+} /* End json_tokenize() */
+
+/**
+ *	@fn 		int json_doc_parse(json_doc_t *doc, const char *js, size_t len, json_tok_t *tokens, int max)
+ *  @brief		Tokenizes a request body, which must be one JSON object
+ *	@param[in]	doc : parsed body for the getters, js / len : body, tokens / max : token array
+ *	@return		count of tokens, JSON_ERROR_xxx (JSON_ERROR_INVAL if the root is not an object)
+ *
+ */
+int json_doc_parse(json_doc_t *doc, const char *js, size_t len, json_tok_t *tokens, int max)
+{
+	int count = json_tokenize(js, len, tokens, max);
+
+	doc->js = js;
+	doc->tokens = tokens;
+	doc->count = 0;
+	if(count < 0)
+		return count;
+	if(count == 0 || tokens[0].type != JSON_OBJECT)
+		return JSON_ERROR_INVAL;
+
+	doc->count = count;
+	return count;
+
+} /* End json_doc_parse() */
+
+/**
+ *	@fn 		int json_find(const json_doc_t *doc, const char *key)
+ *  @brief		Value of a member of the root object
+ *	@param[in]	doc : parsed body, key : member name
+ *	@return		index of the value token, -1 if there is no such member
+ *
+ */
+int json_find(const json_doc_t *doc, const char *key)
+{
+	size_t keyLen = strlen(key);
+
+	for(int i = 1; i + 1 < doc->count; i++){
+		const json_tok_t *tok = &doc->tokens[i];
+		if(tok->parent == 0 && tok->type == JSON_STRING && tok->size == 1 &&
+		   (size_t)(tok->end - tok->start) == keyLen && memcmp(doc->js + tok->start, key, keyLen) == 0)
+			return i + 1;
+	}
+	return -1;
+
+} /* End json_find() */
+
+/**
+ *	@fn 		bool json_get_float(const json_doc_t *doc, const char *key, float *out)
+ *  @brief		Number member of the root object
+ *	@param[in]	doc : parsed body, key : member name, out : value, unchanged on failure
+ *	@return		true if the member is a number
+ *
+ */
+bool json_get_float(const json_doc_t *doc, const char *key, float *out)
+{
+	int i = json_find(doc, key);
+	char number[JSON_NUMBER_MAX + 1];
+	char *end;
+
+	if(i < 0 || doc->tokens[i].type != JSON_PRIMITIVE)
+		return false;
+
+	size_t n = doc->tokens[i].end - doc->tokens[i].start;
+	const char *s = doc->js + doc->tokens[i].start;
+	if(n == 0 || n > JSON_NUMBER_MAX || !(s[0] == '-' || (s[0] >= '0' && s[0] <= '9')))
+		return false;
+	memcpy(number, s, n);
+	number[n] = '\0';
+
+	float value = strtof(number, &end);
+	if(end != number + n)
+		return false;
+	*out = value;
+	return true;
+
+} /* End json_get_float() */
+
+/**
+ *	@fn 		bool json_get_int(const json_doc_t *doc, const char *key, int32_t *out)
+ *  @brief		Integer member of the root object, no fraction nor exponent
+ *	@param[in]	doc : parsed body, key : member name, out : value, unchanged on failure
+ *	@return		true if the member is an integer in the int32_t range
+ *
+ */
+bool json_get_int(const json_doc_t *doc, const char *key, int32_t *out)
+{
+	int i = json_find(doc, key);
+
+	if(i < 0 || doc->tokens[i].type != JSON_PRIMITIVE)
+		return false;
+
+	const char *s = doc->js + doc->tokens[i].start;
+	const char *end = doc->js + doc->tokens[i].end;
+	bool negative = (*s == '-');
+	int64_t value = 0;
+
+	if(negative)
+		s++;
+	if(s == end)
+		return false;
+	for(; s < end; s++){
+		if(*s < '0' || *s > '9')
+			return false;
+		value = value * 10 + (*s - '0');
+		if(value > (int64_t)INT32_MAX + 1)
+			return false;
+	}
+	if(negative)
+		value = -value;
+	if(value > INT32_MAX)
+		return false;
+	*out = (int32_t)value;
+	return true;
+
+} /* End json_get_int() */
+
+/**
+ *	@fn 		bool json_get_bool(const json_doc_t *doc, const char *key, bool *out)
+ *  @brief		true / false member of the root object
+ *	@param[in]	doc : parsed body, key : member name, out : value, unchanged on failure
+ *	@return		true if the member is a boolean
+ *
+ */
+bool json_get_bool(const json_doc_t *doc, const char *key, bool *out)
+{
+	int i = json_find(doc, key);
+
+	if(i < 0 || doc->tokens[i].type != JSON_PRIMITIVE)
+		return false;
+
+	const char *s = doc->js + doc->tokens[i].start;
+	size_t n = doc->tokens[i].end - doc->tokens[i].start;
+	if(n == 4 && memcmp(s, "true", 4) == 0)
+		*out = true;
+	else if(n == 5 && memcmp(s, "false", 5) == 0)
+		*out = false;
+	else
+		return false;
+	return true;
+
+} /* End json_get_bool() */
+
+/**
+ *	@fn 		bool json_get_string(const json_doc_t *doc, const char *key, char *out, size_t size)
+ *  @brief		String member of the root object, copied '\0' terminated
+ *	@param[in]	doc : parsed body, key : member name, out / size : destination
+ *	@return		true if the member is a string that fits in out
+ *
+ */
+bool json_get_string(const json_doc_t *doc, const char *key, char *out, size_t size)
+{
+	int i = json_find(doc, key);
+	size_t n = 0;
+
+	if(i < 0 || doc->tokens[i].type != JSON_STRING || size == 0)
+		return false;
+
+	for(int j = doc->tokens[i].start; j < doc->tokens[i].end; j++){
+		char c = doc->js[j];
+		if(c == '\\'){
+			c = doc->js[++j];
+			if(c != '"' && c != '\\' && c != '/')
+				return false;
+		}
+		if(n + 1 >= size)
+			return false;
+		out[n++] = c;
+	}
+	out[n] = '\0';
+	return true;
+
+} /* End json_get_string() */
+
+/**
+ *	@fn 		bool json_equals(const json_doc_t *doc, const char *key, const char *value)
+ *  @brief		Compares a string member of the root object, without copying it
+ *	@param[in]	doc : parsed body, key : member name, value : expected string (no escape)
+ *	@return		true if the member is the string value
+ *
+ */
+bool json_equals(const json_doc_t *doc, const char *key, const char *value)
+{
+	int i = json_find(doc, key);
+	size_t n = strlen(value);
+
+	return i >= 0 && doc->tokens[i].type == JSON_STRING &&
+		   (size_t)(doc->tokens[i].end - doc->tokens[i].start) == n &&
+		   memcmp(doc->js + doc->tokens[i].start, value, n) == 0;
+
+} /* End json_equals() */
@@ -0,0 +1,80 @@
+/**
+ * @file      esp_mad_json.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the esp_mad_json component, in-place JSON tokenizer of the request bodies.
+ *
+ * @details   jsmn-style : one pass over the body fills a token array given by the caller (on the
+ *            stack), a token only holds the type and the bounds of a value in the body. Nothing is
+ *            allocated nor copied. The getters look a member up in the root object and convert it.
+ *
+ *            e.g. json_tok_t tokens[JSON_SMALL_TOKENS];
+ *                 json_doc_t doc;
+ *                 if(json_doc_parse(&doc, body, len, tokens, JSON_SMALL_TOKENS) < 0) ... invalid
+ *                 if(!json_get_float(&doc, "targetAngle", &angle)) ... missing
+ *
+ */
+
+#ifndef _ESP_MAD_JSON_H_
+
+#define _ESP_MAD_JSON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define JSON_SMALL_TOKENS       16      /* object of up to 7 members                         */
+
+	#define JSON_ERROR_NOMEM        -1      /* more tokens than the array                        */
+	#define JSON_ERROR_INVAL        -2      /* invalid character                                 */
+	#define JSON_ERROR_PART         -3      /* body ends inside a value                          */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef enum {
+		JSON_UNDEFINED,
+		JSON_OBJECT,
+		JSON_ARRAY,
+		JSON_STRING,                        /* bounds without the quotes                          */
+		JSON_PRIMITIVE                      /* number, true, false, null                          */
+	} json_type_t;
+
+	typedef struct {
+		json_type_t type;
+		int16_t start;                      /* first character in the body                        */
+		int16_t end;                        /* past the last character, -1 while open             */
+		int16_t size;                       /* members of an object, items of an array, 1 for a key */
+		int16_t parent;                     /* index of the enclosing token, -1 for the root      */
+	} json_tok_t;
+
+	typedef struct {
+		const char *js;
+		const json_tok_t *tokens;
+		int count;
+	} json_doc_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	int  json_tokenize(const char *js, size_t len, json_tok_t *tokens, int max);
+	int  json_doc_parse(json_doc_t *doc, const char *js, size_t len, json_tok_t *tokens, int max);
+	int  json_find(const json_doc_t *doc, const char *key);
+	bool json_get_float(const json_doc_t *doc, const char *key, float *out);
+	bool json_get_int(const json_doc_t *doc, const char *key, int32_t *out);
+	bool json_get_bool(const json_doc_t *doc, const char *key, bool *out);
+	bool json_get_string(const json_doc_t *doc, const char *key, char *out, size_t size);
+	bool json_equals(const json_doc_t *doc, const char *key, const char *value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
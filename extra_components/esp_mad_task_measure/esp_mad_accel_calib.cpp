@@ -0,0 +1,564 @@
+/**
+ * @file      esp_mad_accel_calib.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Six-position calibration of the MPU6050 accelero : scale, bias and cross-axis terms
+ *
+ * @details   The offset calibration (see calib_sample() in esp_mad_task_measure.cpp) only levels the
+ *            accelero in the mounting position : the scale errors (up to 3 %) and the misalignment
+ *            of the axes are left, and the angle error grows with the throw. Here the MPU6050 is laid
+ *            on its six faces, each face is averaged while still and the correction is the least
+ *            squares fit of the six means to +/-1 g :
+ *
+ *              a = M . raw + b         M : 3x3 (diagonal if ACCEL_CALIB_CROSS_AXIS is 0), b : 3
+ *
+ *            One fit per output axis on the normal equations (4 unknowns, 6 faces). The face of a
+ *            capture is the dominant axis of its mean, so the faces can be laid in any order and a
+ *            face captured again replaces the previous one. The correction is saved in NVS and
+ *            applied in Q14 to the raw samples, before the prefilter; the MPU6050 accelero offset
+ *            registers are then left to 0.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <esp_log.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <nvs.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "esp_mad_accel_calib.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define ACCEL_CAL_NVS_NAMESPACE "esp_mad"
+#define ACCEL_CAL_NVS_KEY       "accel_cal"         /* first MPU6050, "accel_cal_69" for 0x69 ... */
+#define ACCEL_CAL_VERSION       1
+#define ACCEL_CAL_FIRST_ADDRESS 0x68
+#define ACCEL_CAL_ONE_G         16384.0f            /* 2 g range LSB                              */
+#define ACCEL_CAL_SCALE_MAX     0.1f                /* |gain - 1| accepted on the diagonal        */
+#define ACCEL_CAL_BIAS_MAX      0.25f               /* |offset| accepted, g                       */
+
+static const char tag[] = "accel_calib->";
+
+static portMUX_TYPE statusLock = portMUX_INITIALIZER_UNLOCKED;
+static accel_calib_status_t status = {ACCEL_CALIB_IDLE, 0, 0, -1, NULL, {1.0f, 1.0f, 1.0f}, {0}, 0.0f, 0.0f};
+
+static volatile int8_t actionRequest = -1;          /* from the http server, -1 if none          */
+static volatile int8_t sensorRequest;
+
+static float    faceMean[ACCEL_CALIB_FACES][3];     /* 2 g LSB                                    */
+static int32_t  sum[3];
+static int64_t  sumSq[3];
+static uint16_t count;
+static bool     ended;                              /* session over, not yet taken by the measure */
+static bool     clearRequested;
+static accel_cal_t result;
+
+/**
+ *	@fn 		static void set_state(accel_calib_state_t state, const char *error)
+ *  @brief		Session state seen by the http server
+ *
+ */
+static void set_state(accel_calib_state_t state, const char *error)
+{
+	taskENTER_CRITICAL(&statusLock);
+	status.state = state;
+	status.error = error;
+	taskEXIT_CRITICAL(&statusLock);
+
+} /* End set_state() */
+
+/**
+ *	@fn 		static bool solve(int n, float a[4][5])
+ *  @brief		Gaussian elimination with partial pivoting of an augmented n x (n+1) system
+ *	@param[in]	n : unknowns, 4 at most
+ *	@param[in]	a : system, the solution is left in a[i][n]
+ *	@return		false if the system is singular
+ *
+ */
+static bool solve(int n, float a[4][5])
+{
+	for(int c = 0; c < n; c++){
+		int pivot = c;
+		for(int r = c + 1; r < n; r++){
+			if(fabsf(a[r][c]) > fabsf(a[pivot][c]))
+				pivot = r;
+		}
+		if(fabsf(a[pivot][c]) < 1e-6f)
+			return false;
+		for(int k = 0; k <= n; k++){
+			float t = a[c][k];
+			a[c][k] = a[pivot][k];
+			a[pivot][k] = t;
+		}
+		for(int r = 0; r < n; r++){
+			if(r == c)
+				continue;
+			float f = a[r][c] / a[c][c];
+			for(int k = c; k <= n; k++)
+				a[r][k] -= f * a[c][k];
+		}
+	}
+	for(int r = 0; r < n; r++)
+		a[r][n] /= a[r][r];
+	return true;
+
+} /* End solve() */
+
+/**
+ *	@fn 		static const char *fit(void)
+ *  @brief		Least squares fit of the six faces, result in result and status
+ *	@param[in]	void
+ *	@return		NULL, or the reason of the rejection
+ *
+ */
+static const char *fit(void)
+{
+	float m[3][4] = {};
+
+	for(int i = 0; i < 3; i++){
+		/*--- Regressors of the output axis i, in g : the 3 axes (or axis i only) and 1 ---*/
+		int axes[3], n = 0;
+		for(int j = 0; j < 3; j++){
+			if(ACCEL_CALIB_CROSS_AXIS || j == i)
+				axes[n++] = j;
+		}
+
+		float a[4][5] = {};
+		for(int f = 0; f < ACCEL_CALIB_FACES; f++){
+			float x[4];
+			for(int k = 0; k < n; k++)
+				x[k] = faceMean[f][axes[k]] / ACCEL_CAL_ONE_G;
+			x[n] = 1.0f;
+			float y = (f / 2 == i) ? (f % 2 ? -1.0f : 1.0f) : 0.0f;
+
+			for(int r = 0; r <= n; r++){
+				for(int c = 0; c <= n; c++)
+					a[r][c] += x[r] * x[c];
+				a[r][n + 1] += x[r] * y;
+			}
+		}
+		if(!solve(n + 1, a))
+			return "singular fit";
+
+		for(int k = 0; k < n; k++)
+			m[i][axes[k]] = a[k][n + 1];
+		m[i][3] = a[n][n + 1];
+	}
+
+	/*--- Residual on the faces and sanity of the correction ---*/
+	float residual = 0.0f, cross = 0.0f;
+	for(int f = 0; f < ACCEL_CALIB_FACES; f++){
+		for(int i = 0; i < 3; i++){
+			float y = (f / 2 == i) ? (f % 2 ? -1.0f : 1.0f) : 0.0f;
+			float e = m[i][3] - y;
+			for(int j = 0; j < 3; j++)
+				e += m[i][j] * faceMean[f][j] / ACCEL_CAL_ONE_G;
+			residual += e * e;
+		}
+	}
+	residual = sqrtf(residual / ACCEL_CALIB_FACES) * 1000.0f;
+
+	for(int i = 0; i < 3; i++){
+		if(fabsf(m[i][i] - 1.0f) > ACCEL_CAL_SCALE_MAX || fabsf(m[i][3]) > ACCEL_CAL_BIAS_MAX)
+			return "correction out of range";
+		for(int j = 0; j < 3; j++){
+			if(j != i && fabsf(m[i][j]) > cross)
+				cross = fabsf(m[i][j]);
+		}
+	}
+	if(residual > ACCEL_CALIB_RESIDUAL_MAX)
+		return "residual too large";
+
+	/*--- Q14 gains, offsets in Q14 2 g LSB ---*/
+	memset(&result, 0, sizeof(result));
+	result.version = ACCEL_CAL_VERSION;
+	for(int i = 0; i < 3; i++){
+		for(int j = 0; j < 3; j++)
+			result.m[i][j] = lroundf(m[i][j] * (1 << ACCEL_CALIB_Q));
+		result.m[i][3] = lroundf(m[i][3] * ACCEL_CAL_ONE_G * (1 << ACCEL_CALIB_Q));
+	}
+	result.residualMg = residual;
+	result.valid = true;
+
+	taskENTER_CRITICAL(&statusLock);
+	for(int i = 0; i < 3; i++){
+		status.scale[i] = m[i][i];
+		status.biasMg[i] = m[i][3] * 1000.0f;
+	}
+	status.crossAxis = cross;
+	status.residualMg = residual;
+	taskEXIT_CRITICAL(&statusLock);
+
+	ESP_LOGI(tag, "scale %.4f %.4f %.4f, bias %.1f %.1f %.1f mg, cross %.4f, residual %.2f mg",
+			 m[0][0], m[1][1], m[2][2], m[0][3] * 1000.0f, m[1][3] * 1000.0f, m[2][3] * 1000.0f, cross, residual);
+	return NULL;
+
+} /* End fit() */
+
+/**
+ *	@fn 		static const char *capture_end(void)
+ *  @brief		Face of the averaged samples, checks the stillness and the alignment
+ *	@param[in]	void
+ *	@return		NULL, or the reason of the rejection
+ *
+ */
+static const char *capture_end(void)
+{
+	float mean[3], norm = 0.0f;
+	int axis = 0;
+
+	for(int i = 0; i < 3; i++){
+		/*--- N*sum(x^2) - sum(x)^2 = N^2 * variance ---*/
+		int64_t varN2 = (int64_t)count * sumSq[i] - (int64_t)sum[i] * sum[i];
+		if(varN2 > (int64_t)count * count * ACCEL_CALIB_STD_MAX * ACCEL_CALIB_STD_MAX)
+			return "not still";
+		mean[i] = (float)sum[i] / count;
+		norm += mean[i] * mean[i];
+		if(fabsf(mean[i]) > fabsf(mean[axis]))
+			axis = i;
+	}
+	norm = sqrtf(norm);
+
+	if(norm < 0.8f * ACCEL_CAL_ONE_G || norm > 1.2f * ACCEL_CAL_ONE_G)
+		return "not 1 g";
+	if(sqrtf(norm * norm - mean[axis] * mean[axis]) > ACCEL_CALIB_TILT_MAX * norm)
+		return "face not level";
+
+	int face = 2 * axis + (mean[axis] < 0.0f ? 1 : 0);
+	memcpy(faceMean[face], mean, sizeof(mean));
+
+	taskENTER_CRITICAL(&statusLock);
+	status.faces |= 1 << face;
+	status.lastFace = face;
+	taskEXIT_CRITICAL(&statusLock);
+
+	ESP_LOGI(tag, "face %d : %.0f %.0f %.0f", face, mean[0], mean[1], mean[2]);
+	return NULL;
+
+} /* End capture_end() */
+
+/**
+ *	@fn 		bool accel_calib_request(accel_calib_action_t action, int sensor)
+ *  @brief		Session step from the http server, taken into account at the next sample
+ *	@param[in]	action : start, capture, cancel or clear
+ *	@param[in]	sensor : MPU6050 index (start and clear)
+ *	@return		false if the step does not fit the session state
+ *
+ */
+bool accel_calib_request(accel_calib_action_t action, int sensor)
+{
+	accel_calib_state_t state = status.state;
+	bool session = state == ACCEL_CALIB_WAITING || state == ACCEL_CALIB_CAPTURING;
+
+	if(actionRequest >= 0)
+		return false;
+
+	switch(action){
+	case ACCEL_CALIB_START:
+	case ACCEL_CALIB_CLEAR:
+		if(session)
+			return false;
+		break;
+	case ACCEL_CALIB_CAPTURE:
+		if(state != ACCEL_CALIB_WAITING)
+			return false;
+		break;
+	case ACCEL_CALIB_CANCEL:
+		if(!session)
+			return false;
+		break;
+	}
+
+	sensorRequest = sensor;
+	actionRequest = action;
+	return true;
+
+} /* End accel_calib_request() */
+
+/**
+ *	@fn 		void accel_calib_status(accel_calib_status_t *out)
+ *  @brief		Session state and last fit
+ *	@param[out]	out : status
+ *	@return		void
+ *
+ */
+void accel_calib_status(accel_calib_status_t *out)
+{
+	taskENTER_CRITICAL(&statusLock);
+	*out = status;
+	taskEXIT_CRITICAL(&statusLock);
+
+} /* End accel_calib_status() */
+
+/**
+ *	@fn 		int accel_calib_begin(void)
+ *  @brief		Requests of the http server, called by the measure task before the samples
+ *	@param[in]	void
+ *	@return		MPU6050 index of a new session (its correction must be suspended), -1 otherwise
+ *
+ */
+int accel_calib_begin(void)
+{
+	int action = actionRequest;
+
+	if(action == ACCEL_CALIB_START){
+		memset(faceMean, 0, sizeof(faceMean));
+		taskENTER_CRITICAL(&statusLock);
+		status.sensor = sensorRequest;
+		status.faces = 0;
+		status.lastFace = -1;
+		status.state = ACCEL_CALIB_WAITING;
+		status.error = NULL;
+		taskEXIT_CRITICAL(&statusLock);
+		actionRequest = -1;
+		ESP_LOGI(tag, "session started on MPU6050 %d", status.sensor);
+		return status.sensor;
+	}
+
+	if(action == ACCEL_CALIB_CAPTURE){
+		memset(sum, 0, sizeof(sum));
+		memset(sumSq, 0, sizeof(sumSq));
+		count = 0;
+		set_state(ACCEL_CALIB_CAPTURING, NULL);
+		actionRequest = -1;
+	}
+	return -1;
+
+} /* End accel_calib_begin() */
+
+/**
+ *	@fn 		void accel_calib_sample(int sensor, int16_t ax, int16_t ay, int16_t az, uint8_t accelScale)
+ *  @brief		Raw accelero sample, averaged during a capture of the session MPU6050
+ *	@param[in]	sensor : MPU6050 index
+ *	@param[in]	ax, ay, az : raw accelero, without correction
+ *	@param[in]	accelScale : raw x accelScale = 2 g range LSB
+ *	@return		void
+ *
+ */
+void accel_calib_sample(int sensor, int16_t ax, int16_t ay, int16_t az, uint8_t accelScale)
+{
+	if(status.state != ACCEL_CALIB_CAPTURING || sensor != status.sensor)
+		return;
+
+	const int32_t accel[3] = {ax * accelScale, ay * accelScale, az * accelScale};
+	for(int i = 0; i < 3; i++){
+		sum[i] += accel[i];
+		sumSq[i] += (int64_t)accel[i] * accel[i];
+	}
+	if(++count < ACCEL_CALIB_SAMPLES)
+		return;
+
+	const char *error = capture_end();
+	if(error != NULL){
+		ESP_LOGW(tag, "capture rejected : %s", error);
+		taskENTER_CRITICAL(&statusLock);
+		status.lastFace = -1;
+		taskEXIT_CRITICAL(&statusLock);
+		set_state(ACCEL_CALIB_WAITING, error);
+		return;
+	}
+
+	if(status.faces != (1 << ACCEL_CALIB_FACES) - 1){
+		set_state(ACCEL_CALIB_WAITING, NULL);
+		return;
+	}
+
+	error = fit();
+	if(error != NULL)
+		ESP_LOGW(tag, "calibration rejected : %s", error);
+	set_state(error == NULL ? ACCEL_CALIB_DONE : ACCEL_CALIB_FAILED, error);
+	ended = true;
+
+} /* End accel_calib_sample() */
+
+/**
+ *	@fn 		int accel_calib_end(accel_cal_t *cal, bool *clear)
+ *  @brief		End of a session, called by the measure task after the samples
+ *	@param[out]	cal : new correction, not valid if the session is cancelled or rejected
+ *	@param[out]	clear : the stored correction must be erased
+ *	@return		MPU6050 index of the session, -1 if none is over
+ *
+ */
+int accel_calib_end(accel_cal_t *cal, bool *clear)
+{
+	int action = actionRequest;
+
+	if(action == ACCEL_CALIB_CANCEL){
+		set_state(ACCEL_CALIB_IDLE, NULL);
+		memset(&result, 0, sizeof(result));
+		ended = true;
+		actionRequest = -1;
+	}
+	else if(action == ACCEL_CALIB_CLEAR){
+		taskENTER_CRITICAL(&statusLock);
+		status.sensor = sensorRequest;
+		status.state = ACCEL_CALIB_IDLE;
+		status.error = NULL;
+		taskEXIT_CRITICAL(&statusLock);
+		memset(&result, 0, sizeof(result));
+		ended = clearRequested = true;
+		actionRequest = -1;
+	}
+
+	if(!ended)
+		return -1;
+
+	*cal = result;
+	*clear = clearRequested;
+	ended = clearRequested = false;
+	return status.sensor;
+
+} /* End accel_calib_end() */
+
+/**
+ *	@fn 		static void nvs_key(char *key, size_t size, uint8_t devAddr)
+ *  @brief		NVS key of the correction of a MPU6050
+ *
+ */
+static void nvs_key(char *key, size_t size, uint8_t devAddr)
+{
+	if(devAddr == ACCEL_CAL_FIRST_ADDRESS)
+		snprintf(key, size, ACCEL_CAL_NVS_KEY);
+	else
+		snprintf(key, size, ACCEL_CAL_NVS_KEY "_%02x", devAddr);
+
+} /* End nvs_key() */
+
+/**
+ *	@fn 		void accel_cal_load(accel_cal_t *cal, uint8_t devAddr)
+ *  @brief		Correction of a MPU6050 saved in NVS
+ *	@param[out]	cal : correction, not valid if none is saved
+ *	@param[in]	devAddr : I2C address of the MPU6050
+ *	@return		void
+ *
+ */
+void accel_cal_load(accel_cal_t *cal, uint8_t devAddr)
+{
+	nvs_handle_t handle;
+	size_t size = sizeof(*cal);
+	char key[16];
+
+	nvs_key(key, sizeof(key), devAddr);
+	memset(cal, 0, sizeof(*cal));
+
+	/*--- NOT_FOUND : no correction saved yet, identity ---*/
+	esp_err_t err = nvs_open(ACCEL_CAL_NVS_NAMESPACE, NVS_READONLY, &handle);
+	if(err != ESP_OK){
+		if(err == ESP_ERR_NVS_NOT_FOUND)
+			ESP_LOGI(tag, "no %s in NVS, identity", key);
+		else
+			ESP_LOGE(tag, "nvs_open failed (%s), %s not applied", esp_err_to_name(err), key);
+		return;
+	}
+
+	err = nvs_get_blob(handle, key, cal, &size);
+	nvs_close(handle);
+
+	if(err != ESP_OK || size != sizeof(*cal) || cal->version != ACCEL_CAL_VERSION || !cal->valid){
+		if(err != ESP_ERR_NVS_NOT_FOUND)
+			ESP_LOGW(tag, "invalid %s in NVS, ignored", key);
+		else
+			ESP_LOGI(tag, "no %s in NVS, identity", key);
+		memset(cal, 0, sizeof(*cal));
+		return;
+	}
+
+	ESP_LOGI(tag, "%s loaded from NVS, residual %.2f mg", key, cal->residualMg);
+
+} /* End accel_cal_load() */
+
+/**
+ *	@fn 		void accel_cal_save(const accel_cal_t *cal, uint8_t devAddr)
+ *  @brief		Save the correction of a MPU6050 in NVS
+ *	@param[in]	cal : correction
+ *	@param[in]	devAddr : I2C address of the MPU6050
+ *	@return		void
+ *
+ */
+void accel_cal_save(const accel_cal_t *cal, uint8_t devAddr)
+{
+	nvs_handle_t handle;
+	esp_err_t err;
+	char key[16];
+
+	nvs_key(key, sizeof(key), devAddr);
+
+	if((err = nvs_open(ACCEL_CAL_NVS_NAMESPACE, NVS_READWRITE, &handle)) != ESP_OK){
+		ESP_LOGW(tag, "nvs_open failed (%s)", esp_err_to_name(err));
+		return;
+	}
+
+	err = nvs_set_blob(handle, key, cal, sizeof(*cal));
+	if(err == ESP_OK)
+		err = nvs_commit(handle);
+	nvs_close(handle);
+
+	if(err != ESP_OK)
+		ESP_LOGW(tag, "%s not saved (%s)", key, esp_err_to_name(err));
+	else
+		ESP_LOGI(tag, "%s saved", key);
+
+} /* End accel_cal_save() */
+
+/**
+ *	@fn 		void accel_cal_erase(uint8_t devAddr)
+ *  @brief		Erase the correction of a MPU6050 from NVS
+ *	@param[in]	devAddr : I2C address of the MPU6050
+ *	@return		void
+ *
+ */
+void accel_cal_erase(uint8_t devAddr)
+{
+	nvs_handle_t handle;
+	esp_err_t err;
+	char key[16];
+
+	nvs_key(key, sizeof(key), devAddr);
+
+	if((err = nvs_open(ACCEL_CAL_NVS_NAMESPACE, NVS_READWRITE, &handle)) != ESP_OK){
+		ESP_LOGW(tag, "nvs_open failed (%s)", esp_err_to_name(err));
+		return;
+	}
+
+	err = nvs_erase_key(handle, key);
+	if(err == ESP_OK)
+		err = nvs_commit(handle);
+	nvs_close(handle);
+
+	if(err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND)
+		ESP_LOGW(tag, "%s not erased (%s)", key, esp_err_to_name(err));
+
+} /* End accel_cal_erase() */
+
+/**
+ *	@fn 		void accel_cal_apply(const accel_cal_t *cal, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale)
+ *  @brief		Correction of a raw accelero sample, integer only
+ *	@param[in]	cal : correction, nothing is done if not valid
+ *	@param[in,out]	ax, ay, az : raw accelero of the profile range
+ *	@param[in]	accelScale : raw x accelScale = 2 g range LSB
+ *	@return		void
+ *
+ */
+void accel_cal_apply(const accel_cal_t *cal, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale)
+{
+	if(!cal->valid)
+		return;
+
+	const int32_t raw[3] = {*ax * accelScale, *ay * accelScale, *az * accelScale};
+	int16_t *out[3] = {ax, ay, az};
+
+	for(int i = 0; i < 3; i++){
+		int64_t acc = cal->m[i][3] + (1 << (ACCEL_CALIB_Q - 1));
+		for(int j = 0; j < 3; j++)
+			acc += (int64_t)cal->m[i][j] * raw[j];
+		int32_t a = (int32_t)(acc >> ACCEL_CALIB_Q) / accelScale;
+		*out[i] = a > INT16_MAX ? INT16_MAX : (a < INT16_MIN ? INT16_MIN : a);
+	}
+
+} /* End accel_cal_apply() */
@@ -0,0 +1,91 @@
+/**
+ * @file      esp_mad_accel_calib.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the six-position accelero calibration of the esp_mad_task_measure component.
+ *
+ * @details   The session is driven by the http server (start, one capture per face, cancel) and the
+ *            captures are done by the measure task, between two samples. The fitted correction is
+ *            stored in NVS, one per MPU6050, and applied in integer to every raw accelero sample.
+ *            This header is also included by the C http server.
+ *
+ */
+
+#ifndef _ESP_MAD_ACCEL_CALIB_H_
+
+#define _ESP_MAD_ACCEL_CALIB_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define ACCEL_CALIB_CROSS_AXIS  1           /* 1 : full 3x3 matrix (misalignment), 0 : scale and bias only */
+	#define ACCEL_CALIB_FACES       6           /* +X -X +Y -Y +Z -Z up                                        */
+	#define ACCEL_CALIB_SAMPLES     200         /* samples averaged per face, 2 s at 100 Hz                    */
+	#define ACCEL_CALIB_STD_MAX     80          /* accelero standard deviation per axis, 2 g LSB (~5 mg)       */
+	#define ACCEL_CALIB_TILT_MAX    0.25f       /* cross axes / |a| on a face, ~15 degrees                     */
+	#define ACCEL_CALIB_RESIDUAL_MAX 20.0f      /* fit rejected above this rms error, mg                       */
+	#define ACCEL_CALIB_Q           14          /* fixed point of the correction matrix                        */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef enum {
+		ACCEL_CALIB_IDLE,                       /* no session                                     */
+		ACCEL_CALIB_WAITING,                    /* waiting for the next capture request           */
+		ACCEL_CALIB_CAPTURING,                  /* averaging a face                               */
+		ACCEL_CALIB_DONE,                       /* last session fitted and saved                  */
+		ACCEL_CALIB_FAILED                      /* last session rejected, previous one kept       */
+	} accel_calib_state_t;
+
+	typedef enum {
+		ACCEL_CALIB_START,
+		ACCEL_CALIB_CAPTURE,
+		ACCEL_CALIB_CANCEL,
+		ACCEL_CALIB_CLEAR                       /* erase the stored correction                    */
+	} accel_calib_action_t;
+
+	/** Correction of one MPU6050 : a = (m[.][0..2] . raw + m[.][3]) >> ACCEL_CALIB_Q, 2 g LSB */
+	typedef struct {
+		uint32_t version;
+		int32_t  m[3][4];                       /* Q14 gains, offsets in Q14 2 g LSB              */
+		float    residualMg;                    /* rms error of the fit on the six faces          */
+		bool     valid;
+	} accel_cal_t;
+
+	typedef struct {
+		accel_calib_state_t state;
+		uint8_t  sensor;                        /* MPU6050 index of the session                   */
+		uint8_t  faces;                         /* captured faces, bit i : +X -X +Y -Y +Z -Z      */
+		int8_t   lastFace;                      /* face of the last capture, -1 if rejected       */
+		const char *error;                      /* reason of the last rejection, NULL if none     */
+		float    scale[3];                      /* diagonal of the correction                     */
+		float    biasMg[3];                     /* correction offsets                             */
+		float    crossAxis;                     /* largest off-diagonal term                      */
+		float    residualMg;
+	} accel_calib_status_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	bool accel_calib_request(accel_calib_action_t action, int sensor);
+	void accel_calib_status(accel_calib_status_t *out);
+	int  accel_calib_begin(void);
+	void accel_calib_sample(int sensor, int16_t ax, int16_t ay, int16_t az, uint8_t accelScale);
+	int  accel_calib_end(accel_cal_t *cal, bool *clear);
+	void accel_cal_load(accel_cal_t *cal, uint8_t devAddr);
+	void accel_cal_save(const accel_cal_t *cal, uint8_t devAddr);
+	void accel_cal_erase(uint8_t devAddr);
+	void accel_cal_apply(const accel_cal_t *cal, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
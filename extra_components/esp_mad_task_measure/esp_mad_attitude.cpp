@@ -0,0 +1,287 @@
+/**
+ * @file      esp_mad_attitude.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     3-D attitude of the MPU6050 and surface rotation about the hinge axis
+ *
+ * @details   Mahony filter on a quaternion, see https://x-io.co.uk/open-source-imu-and-ahrs-algorithms/
+ *            The gravity direction measured by the accelero is compared with the one predicted by
+ *            the quaternion; their cross product is the attitude error and is fed back to the gyro
+ *            rates before integration. Single precision and no trigonometry in the update, so it
+ *            keeps the 100 Hz loop on the FPU-less ESP32-C3.
+ *
+ *            The hinge axis is unknown until the surface has been moved by more than
+ *            ATTITUDE_HINGE_LEARN degrees from the reference : the axis of that rotation is then the
+ *            hinge axis, whatever the mounting orientation. It is kept across the reference captures
+ *            (/reset) and restored from NVS at boot by the measure task, until forgetHinge().
+ *            Until it is known the angle is the whole rotation since the reference, which is the
+ *            hinge angle for a rotation about the hinge, not its projection on a guessed axis.
+ *            Both are signed by the same orientation of the axis (see axis_sign()), so the angle
+ *            keeps its sign when the axis is learnt. The axis is oriented like -Y when it is close
+ *            to Y : the sign of the historical single axis angle, atan2(ax, az), for the historical
+ *            mounting.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <math.h>
+#include <esp_log.h>
+#include "esp_mad_attitude.h"
+
+static const char tag[] = "attitude->";
+
+#define DEG_TO_RAD  (float)(M_PI / 180.0)
+#define RAD_TO_DEG  (float)(180.0 / M_PI)
+
+/**
+ *	@fn 		static float axis_sign(VectorFloat axis)
+ *  @brief		Orientation of a rotation axis, stable for a given mounting : same side as -Y, or its
+ *				largest component positive when it is nearly orthogonal to Y
+ *	@param[in]	axis : rotation axis, any length
+ *	@return		1.0 or -1.0, factor giving the oriented axis
+ *
+ */
+static float axis_sign(VectorFloat axis)
+{
+	float big = -axis.y;
+
+	if(fabsf(big) < 0.1f * axis.getMagnitude())
+		big = fabsf(axis.x) > fabsf(axis.z) ? axis.x : axis.z;
+	return big < 0.0f ? -1.0f : 1.0f;
+
+} /* End axis_sign() */
+
+/**
+ *	@fn 		Attitude::Attitude()
+ *  @brief		Constructor, no attitude until the first sample, hinge axis unknown
+ *
+ */
+Attitude::Attitude()
+	: hinge(0.0f, -1.0f, 0.0f), integral(0.0f, 0.0f, 0.0f), lastTimestamp(0), referenceValid(false), learnt(false),
+	  learntNow(false)
+{
+}
+
+/**
+ *	@fn 		void Attitude::restart(void)
+ *  @brief		Attitude started again from the next accelero sample (new offsets), the reference is
+ *				captured then. The hinge axis is kept.
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void Attitude::restart(void)
+{
+	integral = VectorFloat(0.0f, 0.0f, 0.0f);
+	lastTimestamp = 0;
+	referenceValid = false;
+	relative = Quaternion();
+
+} /* End restart() */
+
+/**
+ *	@fn 		void Attitude::initFromAccel(float ax, float ay, float az)
+ *  @brief		Start from the shortest rotation bringing the accelero (gravity) on the earth Z axis
+ *	@param[in]	ax, ay, az : normalized accelero
+ *	@return		void
+ *
+ */
+void Attitude::initFromAccel(float ax, float ay, float az)
+{
+	/*--- q = (1 + a.z, a x z), degenerated when the sensor is upside down ---*/
+	if(az > -0.999f)
+		q = Quaternion(1.0f + az, ay, -ax, 0.0f).getNormalized();
+	else
+		q = Quaternion(0.0f, 1.0f, 0.0f, 0.0f);
+
+} /* End initFromAccel() */
+
+/**
+ *	@fn 		void Attitude::update(const attitude_sample_t &sample)
+ *  @brief		Mahony update with a new sample
+ *	@param[in]	sample : accelero, gyro rates and timestamp
+ *	@return		void
+ *
+ */
+void Attitude::update(const attitude_sample_t &sample)
+{
+	float ax = sample.ax, ay = sample.ay, az = sample.az;
+	float norm = sqrtf(ax * ax + ay * ay + az * az);
+	bool accelValid = sample.accelValid && norm != 0.0f;
+
+	if(!accelValid && lastTimestamp == 0)
+		return;
+	if(accelValid){
+		ax /= norm; ay /= norm; az /= norm;
+	}
+
+	if(lastTimestamp == 0){
+		initFromAccel(ax, ay, az);
+		lastTimestamp = sample.timestamp;
+		captureReference();
+		return;
+	}
+
+	float dt = (sample.timestamp - lastTimestamp) * 1e-6f;
+	lastTimestamp = sample.timestamp;
+	if(dt > ATTITUDE_DT_MAX)
+		dt = ATTITUDE_DT_MAX;
+
+	/*--- Gravity predicted by the quaternion, in the sensor frame ---*/
+	float vx = 2.0f * (q.x * q.z - q.w * q.y);
+	float vy = 2.0f * (q.w * q.x + q.y * q.z);
+	float vz = q.w * q.w - q.x * q.x - q.y * q.y + q.z * q.z;
+
+	/*--- Error = measured x predicted, none when the accelero is rejected (gyro only) ---*/
+	float ex = 0.0f, ey = 0.0f, ez = 0.0f;
+	if(accelValid){
+		ex = ay * vz - az * vy;
+		ey = az * vx - ax * vz;
+		ez = ax * vy - ay * vx;
+	}
+
+	integral.x += ATTITUDE_KI * ex * dt;
+	integral.y += ATTITUDE_KI * ey * dt;
+	integral.z += ATTITUDE_KI * ez * dt;
+
+	float gx = sample.gx * DEG_TO_RAD + ATTITUDE_KP * ex + integral.x;
+	float gy = sample.gy * DEG_TO_RAD + ATTITUDE_KP * ey + integral.y;
+	float gz = sample.gz * DEG_TO_RAD + ATTITUDE_KP * ez + integral.z;
+
+	/*--- q += 0.5 * q * (0, g) * dt ---*/
+	float h = 0.5f * dt;
+	Quaternion dq(-q.x * gx - q.y * gy - q.z * gz,
+	               q.w * gx + q.y * gz - q.z * gy,
+	               q.w * gy - q.x * gz + q.z * gx,
+	               q.w * gz + q.x * gy - q.y * gx);
+	q.w += dq.w * h; q.x += dq.x * h; q.y += dq.y * h; q.z += dq.z * h;
+	q.normalize();
+
+	relative = reference.getConjugate().getProduct(q);
+	if(!learnt)
+		learnHinge();
+
+} /* End update() */
+
+/**
+ *	@fn 		void Attitude::learnHinge(void)
+ *  @brief		Take the axis of the first large rotation since the reference as hinge axis
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void Attitude::learnHinge(void)
+{
+	VectorFloat axis(relative.x, relative.y, relative.z);
+	float s = axis.getMagnitude();
+
+	if(2.0f * atan2f(s, fabsf(relative.w)) < ATTITUDE_HINGE_LEARN * DEG_TO_RAD)
+		return;
+
+	s *= axis_sign(axis);
+	hinge = VectorFloat(axis.x / s, axis.y / s, axis.z / s);
+	learnt = true;
+	learntNow = true;
+	ESP_LOGI(tag, "hinge axis learnt : %.2f %.2f %.2f", hinge.x, hinge.y, hinge.z);
+
+} /* End learnHinge() */
+
+/**
+ *	@fn 		void Attitude::setHinge(const VectorFloat &axis)
+ *  @brief		Hinge axis known from a previous session (NVS)
+ *	@param[in]	axis : unit hinge axis in the sensor frame
+ *	@return		void
+ *
+ */
+void Attitude::setHinge(const VectorFloat &axis)
+{
+	hinge = axis;
+	learnt = true;
+	learntNow = false;
+
+} /* End setHinge() */
+
+/**
+ *	@fn 		void Attitude::forgetHinge(void)
+ *  @brief		Sensor moved to another surface : the hinge axis is learnt again from the current
+ *				orientation
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void Attitude::forgetHinge(void)
+{
+	hinge = VectorFloat(0.0f, -1.0f, 0.0f);
+	learnt = false;
+	learntNow = false;
+	if(lastTimestamp != 0)
+		captureReference();
+
+} /* End forgetHinge() */
+
+/**
+ *	@fn 		bool Attitude::hingeToSave(void)
+ *  @brief		Hinge axis learnt since the last call
+ *	@param[in]	void
+ *	@return		true once after learnHinge()
+ *
+ */
+bool Attitude::hingeToSave(void)
+{
+	bool save = learntNow;
+
+	learntNow = false;
+	return save;
+
+} /* End hingeToSave() */
+
+/**
+ *	@fn 		void Attitude::captureReference(void)
+ *  @brief		Current orientation becomes the zero of the surface, the hinge axis is kept
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void Attitude::captureReference(void)
+{
+	reference = q;
+	relative = Quaternion();
+	referenceValid = true;
+
+} /* End captureReference() */
+
+/**
+ *	@fn 		float Attitude::hingeAngle(void)
+ *  @brief		Surface rotation since the reference, about the hinge axis (whole rotation until the
+ *				axis is learnt)
+ *	@param[in]	void
+ *	@return		angle in degree, -180 to 180
+ *
+ */
+float Attitude::hingeAngle(void)
+{
+	if(!referenceValid)
+		return 0.0f;
+
+	/*--- Hinge unknown : whole rotation, signed by the orientation of its own axis ---*/
+	if(!learnt){
+		VectorFloat axis(relative.x, relative.y, relative.z);
+		float s = axis.getMagnitude() * axis_sign(axis);
+		if(relative.w < 0.0f)
+			s = -s;
+		return 2.0f * atan2f(s, fabsf(relative.w)) * RAD_TO_DEG;
+	}
+
+	/*--- Twist of the relative rotation about the hinge : 2 * atan2(v.h, w) ---*/
+	float projection = relative.x * hinge.x + relative.y * hinge.y + relative.z * hinge.z;
+	float angle = 2.0f * atan2f(projection, relative.w) * RAD_TO_DEG;
+
+	if(angle > 180.0f)
+		angle -= 360.0f;
+	else if(angle < -180.0f)
+		angle += 360.0f;
+	return angle;
+
+} /* End hingeAngle() */
@@ -0,0 +1,69 @@
+/**
+ * @file      esp_mad_attitude.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     3-D attitude of the MPU6050 for the esp_mad_task_measure component.
+ *
+ * @details   The attitude is a quaternion (helper_3dmath.h) updated by a 6-axis Mahony filter,
+ *            so the sensor can be clipped on the control surface in any orientation. The surface
+ *            travel is the rotation since a captured reference orientation, taken about the hinge
+ *            axis (swing / twist decomposition of the relative quaternion). The hinge axis is kept
+ *            across the reference captures and saved by the measure task.
+ *
+ */
+
+#ifndef _ESP_MAD_ATTITUDE_H_
+
+#define _ESP_MAD_ATTITUDE_H_
+
+#include <stdint.h>
+#include "helper_3dmath.h"
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define ATTITUDE_KP             2.0f        /* Mahony proportional gain on the accelero error          */
+	#define ATTITUDE_KI             0.02f       /* Mahony integral gain, tracks the remaining gyro bias    */
+	#define ATTITUDE_DT_MAX         0.1f        /* dt limit in s                                           */
+	#define ATTITUDE_HINGE_LEARN    10.0f       /* rotation in degree after which the hinge axis is learnt */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	/** One MPU6050 sample, raw accelero and gyro rates with the bias removed. */
+	typedef struct {
+		int64_t timestamp;              /* sample time in us (esp_timer_get_time())       */
+		int16_t ax, ay, az;             /* raw accelero                                   */
+		float   gx, gy, gz;             /* gyro rates in deg/s                            */
+		bool    accelValid;             /* false : accelero rejected by the prefilter     */
+	} attitude_sample_t;
+
+	class Attitude {
+		public:
+			Attitude();
+			void update(const attitude_sample_t &sample);
+			void restart(void);
+			void captureReference(void);
+			float hingeAngle(void);
+			bool hingeLearnt(void) { return learnt; }
+			VectorFloat hingeAxis(void) { return hinge; }
+			void setHinge(const VectorFloat &axis);
+			void forgetHinge(void);
+			bool hingeToSave(void);
+
+		private:
+			void initFromAccel(float ax, float ay, float az);
+			void learnHinge(void);
+
+			Quaternion q;               // sensor to earth
+			Quaternion reference;       // q at the last captureReference()
+			Quaternion relative;        // rotation since the reference, in the sensor frame
+			VectorFloat hinge;          // hinge axis in the sensor frame
+			VectorFloat integral;       // Mahony integral term in rad/s
+			int64_t lastTimestamp;
+			bool referenceValid;
+			bool learnt;
+			bool learntNow;             // learnt since the last hingeToSave()
+	};
+
+#endif
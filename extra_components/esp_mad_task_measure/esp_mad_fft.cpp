@@ -0,0 +1,80 @@
+/**
+ * @file      esp_mad_fft.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Fixed-point radix-2 FFT
+ *
+ * @details   In place decimation in time : bit reversal, then log2(size) stages of butterflies with
+ *            W = cos - j.sin in Q15. Each stage halves its outputs, so an input below 2^(31 - log2(size))
+ *            can never overflow and the output is the DFT scaled by 1 / size.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <math.h>
+#include "esp_mad_fft.h"
+
+/**
+ *	@fn 		void fft_q15_twiddles(int16_t *cosTable, int16_t *sinTable, int size)
+ *  @brief		Q15 twiddle tables of a size points FFT
+ *	@param[out]	cosTable / sinTable : size / 2 entries each
+ *	@param[in]	size : FFT size, a power of 2
+ *	@return		void
+ *
+ */
+void fft_q15_twiddles(int16_t *cosTable, int16_t *sinTable, int size)
+{
+	for(int k = 0; k < size / 2; k++){
+		float a = 2.0f * (float)M_PI * k / size;
+		cosTable[k] = (int16_t)lrintf(cosf(a) * 32767.0f);
+		sinTable[k] = (int16_t)lrintf(sinf(a) * 32767.0f);
+	}
+
+} /* End fft_q15_twiddles() */
+
+/**
+ *	@fn 		void fft_q15(int32_t *re, int32_t *im, int size, const int16_t *cosTable, const int16_t *sinTable)
+ *  @brief		In place radix-2 DIT FFT, output scaled by 1 / size
+ *	@param[in]	re / im : size samples, replaced by the spectrum
+ *	@param[in]	size : FFT size, a power of 2
+ *	@param[in]	cosTable / sinTable : tables of fft_q15_twiddles() for this size
+ *	@return		void
+ *
+ */
+void fft_q15(int32_t *re, int32_t *im, int size, const int16_t *cosTable, const int16_t *sinTable)
+{
+	/*--- Bit reversal ---*/
+	for(int i = 1, j = 0; i < size; i++){
+		int bit = size >> 1;
+		for(; j & bit; bit >>= 1)
+			j ^= bit;
+		j |= bit;
+		if(i < j){
+			int32_t t = re[i]; re[i] = re[j]; re[j] = t;
+			t = im[i]; im[i] = im[j]; im[j] = t;
+		}
+	}
+
+	/*--- Butterflies, W = cos - j.sin ---*/
+	for(int span = 2; span <= size; span <<= 1){
+		int half = span >> 1;
+		int step = size / span;
+
+		for(int i = 0; i < size; i += span){
+			for(int j = 0; j < half; j++){
+				int32_t wr = cosTable[j * step];
+				int32_t wi = -sinTable[j * step];
+				int a = i + j, b = a + half;
+				int32_t tr = (int32_t)(((int64_t)re[b] * wr - (int64_t)im[b] * wi) >> 15);
+				int32_t ti = (int32_t)(((int64_t)re[b] * wi + (int64_t)im[b] * wr) >> 15);
+				re[b] = (re[a] - tr) >> 1;
+				im[b] = (im[a] - ti) >> 1;
+				re[a] = (re[a] + tr) >> 1;
+				im[a] = (im[a] + ti) >> 1;
+			}
+		}
+	}
+
+} /* End fft_q15() */
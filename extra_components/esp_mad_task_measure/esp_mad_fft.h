@@ -0,0 +1,24 @@
+/**
+ * @file      esp_mad_fft.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the fixed-point FFT of the esp_mad_task_measure component.
+ *
+ * @details   Radix-2 decimation in time FFT on int32 data with Q15 twiddles, used by the jitter
+ *            analysis. No IDF dependency, so it is also built on the host (tools/host/fft_check.cpp).
+ *
+ */
+
+#ifndef _ESP_MAD_FFT_H_
+
+#define _ESP_MAD_FFT_H_
+
+#include <stdint.h>
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void fft_q15_twiddles(int16_t *cosTable, int16_t *sinTable, int size);
+	void fft_q15(int32_t *re, int32_t *im, int size, const int16_t *cosTable, const int16_t *sinTable);
+
+#endif
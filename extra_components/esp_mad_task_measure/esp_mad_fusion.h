@@ -0,0 +1,188 @@
+/**
+ * @file      esp_mad_fusion.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Accelero / gyro fusion filters of the esp_mad_task_measure component.
+ *
+ * @details   The filter is chosen at compile time with ESP_MAD_FUSION_FILTER, the measure loop
+ *            calls FusionFilter<Policy>::update() directly (no virtual call). All the policies
+ *            take the same fusion_sample_t and return the angle in degree.
+ *
+ *            A policy provides :
+ *              - void  reset(float accAngle)                      : start from the accelero angle
+ *              - float step(float accAngle, float rate, float dt) : one update, returns the angle
+ *              - float predict(float rate, float dt)               : gyro only, accelero rejected
+ *
+ */
+
+#ifndef _ESP_MAD_FUSION_H_
+
+#define _ESP_MAD_FUSION_H_
+
+#include <stdint.h>
+#include <math.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define ESP_MAD_FUSION_COMPLEMENTARY    0
+	#define ESP_MAD_FUSION_MAHONY           1
+	#define ESP_MAD_FUSION_KALMAN           2
+
+	#ifndef ESP_MAD_FUSION_FILTER
+		#define ESP_MAD_FUSION_FILTER   ESP_MAD_FUSION_COMPLEMENTARY
+	#endif
+
+	#define FUSION_DT_MAX   0.1f        /* dt limit in s, a long gap (bus recovery) must not throw the angle away */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	/** One MPU6050 sample, raw accelero and gyro rate with the bias removed. */
+	typedef struct {
+		int64_t timestamp;              /* sample time in us (esp_timer_get_time())       */
+		int16_t ax, ay, az;             /* raw accelero                                   */
+		float   rate;                   /* gyro rate around the measured axis in deg/s    */
+		bool    accelValid;             /* false : accelero rejected by the prefilter     */
+	} fusion_sample_t;
+
+	/**
+	 *	@brief		Complementary filter, angle = a * (angle + rate * dt) + (1 - a) * accAngle
+	 */
+	struct ComplementaryPolicy {
+		static constexpr float alpha = 0.98f;
+		float angle;
+
+		void reset(float accAngle) { angle = accAngle; }
+
+		float step(float accAngle, float rate, float dt){
+			angle = alpha * (angle + rate * dt) + (1.0f - alpha) * accAngle;
+			return angle;
+		}
+
+		float predict(float rate, float dt){
+			angle += rate * dt;
+			return angle;
+		}
+	};
+
+	/**
+	 *	@brief		Mahony filter reduced to one axis : the accelero error drives a PI feedback on
+	 *				the gyro rate, the integral term tracks the remaining gyro bias.
+	 */
+	struct MahonyPolicy {
+		static constexpr float kp = 2.0f;
+		static constexpr float ki = 0.05f;
+		float angle;
+		float integral;
+
+		void reset(float accAngle) { angle = accAngle; integral = 0.0f; }
+
+		float step(float accAngle, float rate, float dt){
+			float error = accAngle - angle;
+			integral += ki * error * dt;
+			angle += (rate + kp * error + integral) * dt;
+			return angle;
+		}
+
+		float predict(float rate, float dt){
+			angle += (rate + integral) * dt;
+			return angle;
+		}
+	};
+
+	/**
+	 *	@brief		Kalman filter on one axis, state is angle and gyro bias, accelero angle is the
+	 *				measurement (see http://blog.tkjelectronics.dk/2012/09/a-practical-approach-to-kalman-filter-and-how-to-implement-it/)
+	 */
+	struct KalmanPolicy {
+		static constexpr float qAngle = 0.001f;     /* process noise of the angle          */
+		static constexpr float qBias = 0.003f;      /* process noise of the gyro bias      */
+		static constexpr float rMeasure = 0.03f;    /* measurement noise of the accelero   */
+		float angle;
+		float bias;
+		float p[2][2];
+
+		void reset(float accAngle){
+			angle = accAngle;
+			bias = 0.0f;
+			p[0][0] = p[0][1] = p[1][0] = p[1][1] = 0.0f;
+		}
+
+		float predict(float rate, float dt){
+			angle += (rate - bias) * dt;
+			p[0][0] += dt * (dt * p[1][1] - p[0][1] - p[1][0] + qAngle);
+			p[0][1] -= dt * p[1][1];
+			p[1][0] -= dt * p[1][1];
+			p[1][1] += qBias * dt;
+			return angle;
+		}
+
+		float step(float accAngle, float rate, float dt){
+			predict(rate, dt);
+
+			/*--- Update ---*/
+			float s = p[0][0] + rMeasure;
+			float k0 = p[0][0] / s;
+			float k1 = p[1][0] / s;
+			float y = accAngle - angle;
+			angle += k0 * y;
+			bias += k1 * y;
+
+			float p00 = p[0][0], p01 = p[0][1];
+			p[0][0] -= k0 * p00;
+			p[0][1] -= k0 * p01;
+			p[1][0] -= k1 * p00;
+			p[1][1] -= k1 * p01;
+			return angle;
+		}
+	};
+
+	/**
+	 *	@brief		Common part of the filters : accelero angle, dt from the timestamps, output.
+	 */
+	template <class Policy>
+	class FusionFilter {
+		Policy policy;
+		int64_t lastTimestamp = 0;
+		float currentAngle = 0.0f;
+
+	public:
+		/**
+		 *	@fn 		float update(const fusion_sample_t &sample)
+		 *  @brief		Fuse a new sample
+		 *	@param[in]	sample : accelero, gyro rate and timestamp
+		 *	@return		angle in degree
+		 */
+		float update(const fusion_sample_t &sample){
+			if(lastTimestamp == 0){
+				if(!sample.accelValid)
+					return currentAngle;
+				float accAngle = atan2f((float)sample.ax, (float)sample.az) * (180.0f / (float)M_PI);
+				policy.reset(accAngle);
+				currentAngle = accAngle;
+			}
+			else{
+				float dt = (sample.timestamp - lastTimestamp) * 1e-6f;
+				dt = dt < FUSION_DT_MAX ? dt : FUSION_DT_MAX;
+				if(sample.accelValid)
+					currentAngle = policy.step(atan2f((float)sample.ax, (float)sample.az) * (180.0f / (float)M_PI), sample.rate, dt);
+				else
+					currentAngle = policy.predict(sample.rate, dt);
+			}
+			lastTimestamp = sample.timestamp;
+			return currentAngle;
+		}
+
+		float angle(void) const { return currentAngle; }
+	};
+
+	#if ESP_MAD_FUSION_FILTER == ESP_MAD_FUSION_MAHONY
+		typedef FusionFilter<MahonyPolicy> fusion_filter_t;
+	#elif ESP_MAD_FUSION_FILTER == ESP_MAD_FUSION_KALMAN
+		typedef FusionFilter<KalmanPolicy> fusion_filter_t;
+	#else
+		typedef FusionFilter<ComplementaryPolicy> fusion_filter_t;
+	#endif
+
+#endif
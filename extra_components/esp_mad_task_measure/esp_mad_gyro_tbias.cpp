@@ -0,0 +1,246 @@
+/**
+ * @file      esp_mad_gyro_tbias.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Temperature to gyro bias model of the MPU6050
+ *
+ * @details   The gyro bias of the MPU6050 follows the die temperature, which rises by several
+ *            degrees after power-on. The model is a piecewise-linear table (one node every
+ *            TBIAS_T_STEP °C) fitted from the gyro means of the still windows detected by the
+ *            measure task. It is stored in NVS so a unit learns its own curve along the sessions.
+ *
+ *            Biases are stored without the XG_OFFS_USR offsets computed by the offset calibration,
+ *            which differ at each power-on and recalibration: bias read = table bias + 4 * offset.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <esp_log.h>
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <nvs.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include "esp_mad_gyro_tbias.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define TBIAS_NVS_NAMESPACE     "esp_mad"
+#define TBIAS_NVS_KEY           "gyro_tbias"        /* first MPU6050, "gyro_tbias_69" for 0x69 ... */
+#define TBIAS_VERSION           1
+#define TBIAS_FIRST_ADDRESS     0x68
+
+static const char tag[] = "gyro_tbias->";
+
+/**
+ *	@fn 		void gyro_tbias_init(gyro_tbias_t *model, uint8_t devAddr, const int gyroOffset[3])
+ *  @brief		Load the table of a MPU6050 from NVS
+ *	@param[out]	model : model to initialize
+ *	@param[in]	devAddr : I2C address of the MPU6050, each one has its own table
+ *	@param[in]	gyroOffset : X, Y, Z gyro offsets written in the MPU6050
+ *	@return		void
+ *
+ */
+void gyro_tbias_init(gyro_tbias_t *model, uint8_t devAddr, const int gyroOffset[3])
+{
+	gyro_tbias_table_t &table = model->table;
+	nvs_handle_t handle;
+	size_t size = sizeof(table);
+
+	for(int i = 0; i < 3; i++)
+		model->hwOffset[i] = (float)(gyroOffset[i] * TBIAS_GYRO_OFFSET_SCALE);
+
+	if(devAddr == TBIAS_FIRST_ADDRESS)
+		strcpy(model->key, TBIAS_NVS_KEY);
+	else
+		snprintf(model->key, sizeof(model->key), TBIAS_NVS_KEY "_%02x", devAddr);
+
+	memset(&table, 0, sizeof(table));
+	table.version = TBIAS_VERSION;
+	model->dirty = false;
+	model->readFailed = false;
+	model->lastSave = xTaskGetTickCount();
+
+	/*--- NOT_FOUND : the namespace is created by the first save ---*/
+	esp_err_t err = nvs_open(TBIAS_NVS_NAMESPACE, NVS_READONLY, &handle);
+	if(err == ESP_ERR_NVS_NOT_FOUND){
+		ESP_LOGI(tag, "no table in NVS, starting a new one");
+		return;
+	}
+	if(err != ESP_OK){
+		ESP_LOGE(tag, "nvs_open failed (%s), %s not restored nor saved", esp_err_to_name(err), model->key);
+		model->readFailed = true;
+		return;
+	}
+
+	err = nvs_get_blob(handle, model->key, &table, &size);
+	if(err == ESP_ERR_NVS_NOT_FOUND){
+		ESP_LOGI(tag, "no table in NVS, starting a new one");
+		memset(&table, 0, sizeof(table));
+		table.version = TBIAS_VERSION;
+	}
+	else if(err != ESP_OK || size != sizeof(table) || table.version != TBIAS_VERSION){
+		ESP_LOGW(tag, "invalid table in NVS, starting a new one");
+		memset(&table, 0, sizeof(table));
+		table.version = TBIAS_VERSION;
+	}
+	else
+		ESP_LOGI(tag, "table loaded from NVS");
+
+	nvs_close(handle);
+
+} /* End gyro_tbias_init() */
+
+/**
+ *	@fn 		static float node_position(float temperature, int *node)
+ *  @brief		Position of a temperature in the table
+ *	@param[in]	temperature : in °C
+ *	@param[out]	node : index of the node below (0 to TBIAS_NODES-2)
+ *	@return		fraction of the way to the next node, 0.0 to 1.0
+ *
+ */
+static float node_position(float temperature, int *node)
+{
+	float x = (temperature - TBIAS_T_MIN) / TBIAS_T_STEP;
+	int i = (int)floorf(x);
+
+	if(i < 0)
+		i = 0;
+	if(i > TBIAS_NODES - 2)
+		i = TBIAS_NODES - 2;
+
+	*node = i;
+	return fminf(fmaxf(x - i, 0.0f), 1.0f);
+
+} /* End node_position() */
+
+/**
+ *	@fn 		void gyro_tbias_learn(gyro_tbias_t *model, float temperature, const float windowMean[3])
+ *  @brief		Fit the table with the gyro mean of a still window
+ *
+ *  @details	The sample is shared between the two nodes around the temperature, in proportion
+ *				to its distance to each of them, and averaged in their bias.
+ *	@param[in]	model : model of the MPU6050
+ *	@param[in]	temperature : die temperature in °C
+ *	@param[in]	windowMean : X, Y, Z gyro mean of the window, raw LSB
+ *	@return		void
+ *
+ */
+void gyro_tbias_learn(gyro_tbias_t *model, float temperature, const float windowMean[3])
+{
+	gyro_tbias_table_t &table = model->table;
+	int node;
+	float f = node_position(temperature, &node);
+	const float w[2] = {1.0f - f, f};
+
+	for(int n = 0; n < 2; n++){
+		float *weight = &table.weight[node + n];
+		if(w[n] <= 0.0f)
+			continue;
+
+		for(int i = 0; i < 3; i++){
+			float bias = windowMean[i] - model->hwOffset[i];
+			table.bias[node + n][i] += w[n] * (bias - table.bias[node + n][i]) / (*weight + w[n]);
+		}
+		*weight = fminf(*weight + w[n], TBIAS_MAX_WEIGHT);
+	}
+	model->dirty = true;
+
+} /* End gyro_tbias_learn() */
+
+/**
+ *	@fn 		bool gyro_tbias_get(const gyro_tbias_t *model, float temperature, float bias[3])
+ *  @brief		Gyro bias predicted by the table
+ *
+ *  @details	Linear interpolation between the nearest learnt nodes around the temperature,
+ *				the nearest learnt node is used alone out of the learnt range.
+ *	@param[in]	model : model of the MPU6050
+ *	@param[in]	temperature : die temperature in °C
+ *	@param[out]	bias : X, Y, Z gyro bias expected in the readings, raw LSB (0 without model)
+ *	@return		true if the table has a learnt node
+ *
+ */
+bool gyro_tbias_get(const gyro_tbias_t *model, float temperature, float bias[3])
+{
+	const gyro_tbias_table_t &table = model->table;
+	int node, lo, hi;
+	float f = node_position(temperature, &node);
+	float x = node + f;
+
+	for(lo = node; lo >= 0 && table.weight[lo] < TBIAS_MIN_WEIGHT; lo--);
+	for(hi = node + 1; hi < TBIAS_NODES && table.weight[hi] < TBIAS_MIN_WEIGHT; hi++);
+
+	if(lo < 0 && hi >= TBIAS_NODES){
+		bias[0] = bias[1] = bias[2] = 0.0f;
+		return false;
+	}
+
+	if(lo < 0)
+		lo = hi;
+	if(hi >= TBIAS_NODES)
+		hi = lo;
+
+	float t = (hi == lo) ? 0.0f : fminf(fmaxf((x - lo) / (hi - lo), 0.0f), 1.0f);
+	for(int i = 0; i < 3; i++)
+		bias[i] = table.bias[lo][i] + t * (table.bias[hi][i] - table.bias[lo][i]) + model->hwOffset[i];
+
+	return true;
+
+} /* End gyro_tbias_get() */
+
+/**
+ *	@fn 		void gyro_tbias_save(gyro_tbias_t *model)
+ *  @brief		Store the table in NVS when it changed, at most every TBIAS_SAVE_PERIOD_MS,
+ *				never over a table that could not be read at init
+ *	@param[in]	model : model of the MPU6050
+ *	@return		void
+ *
+ */
+void gyro_tbias_save(gyro_tbias_t *model)
+{
+	nvs_handle_t handle;
+	esp_err_t err;
+
+	if(model->readFailed || !model->dirty || (xTaskGetTickCount() - model->lastSave) < pdMS_TO_TICKS(TBIAS_SAVE_PERIOD_MS))
+		return;
+
+	model->lastSave = xTaskGetTickCount();
+
+	if((err = nvs_open(TBIAS_NVS_NAMESPACE, NVS_READWRITE, &handle)) != ESP_OK){
+		ESP_LOGW(tag, "nvs_open failed (%s)", esp_err_to_name(err));
+		return;
+	}
+
+	err = nvs_set_blob(handle, model->key, &model->table, sizeof(model->table));
+	if(err == ESP_OK)
+		err = nvs_commit(handle);
+	nvs_close(handle);
+
+	if(err != ESP_OK)
+		ESP_LOGW(tag, "table not saved (%s)", esp_err_to_name(err));
+	else{
+		model->dirty = false;
+		ESP_LOGI(tag, "table %s saved", model->key);
+	}
+
+} /* End gyro_tbias_save() */
+
+/**
+ *	@fn 		void gyro_tbias_offset(gyro_tbias_t *model, const int gyroOffset[3])
+ *  @brief		New XG_OFFS_USR offsets written by a recalibration, the table is kept
+ *	@param[in]	model : model of the MPU6050
+ *	@param[in]	gyroOffset : X, Y, Z gyro offsets written in the MPU6050
+ *	@return		void
+ *
+ */
+void gyro_tbias_offset(gyro_tbias_t *model, const int gyroOffset[3])
+{
+	for(int i = 0; i < 3; i++)
+		model->hwOffset[i] = (float)(gyroOffset[i] * TBIAS_GYRO_OFFSET_SCALE);
+
+} /* End gyro_tbias_offset() */
@@ -0,0 +1,58 @@
+/**
+ * @file      esp_mad_gyro_tbias.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the gyro temperature bias model of the esp_mad_task_measure component.
+ *
+ * @details   Protypes and define for the temperature to gyro bias model, one model per MPU6050.
+ *
+ */
+
+#ifndef _ESP_MAD_GYRO_TBIAS_H_
+
+#define _ESP_MAD_GYRO_TBIAS_H_
+
+#include <stdint.h>
+#include <freertos/FreeRTOS.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define TBIAS_T_MIN             -10.0f      /* Temperature of the first node of the table in °C                 */
+	#define TBIAS_T_STEP            5.0f        /* Temperature step between two nodes in °C                         */
+	#define TBIAS_NODES             17          /* Nodes number, table covers -10 °C to 70 °C                       */
+	#define TBIAS_MIN_WEIGHT        2.0f        /* Still windows needed before a node is used                       */
+	#define TBIAS_MAX_WEIGHT        100.0f      /* Weight limit of a node, keeps the table adapting to aging        */
+	#define TBIAS_SAVE_PERIOD_MS    600000      /* Minimum time between two NVS writes of the table (10 mn)         */
+	#define TBIAS_GYRO_OFFSET_SCALE 4           /* Raw gyro LSB (250 deg/s) per XG_OFFS_USR LSB (1000 deg/s)        */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	/** Table as stored in NVS */
+	typedef struct {
+		uint32_t version;
+		float    weight[TBIAS_NODES];               /* still windows learnt by the node (weighted)  */
+		float    bias[TBIAS_NODES][3];              /* gyro bias without XG_OFFS_USR, raw LSB       */
+	} gyro_tbias_table_t;
+
+	/** Model of one MPU6050 */
+	typedef struct {
+		gyro_tbias_table_t table;
+		float      hwOffset[3];                     /* bias removed by the XG_OFFS_USR registers    */
+		char       key[16];                         /* NVS key of the table                         */
+		bool       dirty;
+		bool       readFailed;                      /* NVS not readable at init : never saved over  */
+		TickType_t lastSave;
+	} gyro_tbias_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void gyro_tbias_init(gyro_tbias_t *model, uint8_t devAddr, const int gyroOffset[3]);
+	void gyro_tbias_learn(gyro_tbias_t *model, float temperature, const float windowMean[3]);
+	bool gyro_tbias_get(const gyro_tbias_t *model, float temperature, float bias[3]);
+	void gyro_tbias_save(gyro_tbias_t *model);
+	void gyro_tbias_offset(gyro_tbias_t *model, const int gyroOffset[3]);
+
+#endif
@@ -0,0 +1,308 @@
+/**
+ * @file      esp_mad_jitter.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Servo jitter / flutter analysis : spectrum of the gyro Y rate
+ *
+ * @details   Buzzing servos and linkage flutter are gyro oscillations that the angle filter hides.
+ *            Blocks of JITTER_FFT_SIZE samples are Hann windowed and transformed by a radix-2
+ *            decimation in time FFT in fixed point (esp_mad_fft.cpp : Q15 twiddles, int32 data scaled
+ *            by 1/2 at each stage, so no stage can overflow). The power spectra of the blocks are averaged
+ *            (Welch) from the start of the analysis, and give :
+ *
+ *              - the rms of the gyro rate per band (Parseval, Hann window power corrected)
+ *              - the JITTER_PEAKS strongest local maxima, frequency refined by parabolic interpolation
+ *                and amplitude taken from the 3 bins of the main lobe
+ *
+ *            jitter_push() only copies samples : a full block is handed to the analysis task, or
+ *            dropped (overrun) if the task is still busy with the other one, so the measure loop is
+ *            never stalled.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "esp_mad_jitter.h"
+#include "esp_mad_fft.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define JITTER_INPUT_SHIFT      7           /* windowed samples << 7 : 2^22 max, headroom for 8 stages */
+#define JITTER_HANN_POWER       0.375f      /* mean of the squared Hann window                         */
+#define JITTER_BINS             (JITTER_FFT_SIZE / 2)
+
+static const char tag[] = "jitter->";
+static const int bandHz[JITTER_BANDS + 1] = JITTER_BAND_HZ;
+
+static TaskHandle_t jitterTask = NULL;
+static portMUX_TYPE resultLock = portMUX_INITIALIZER_UNLOCKED;
+
+/*--- Tables, built once ---*/
+static int16_t cosTable[JITTER_BINS];       /* Q15 */
+static int16_t sinTable[JITTER_BINS];       /* Q15 */
+static int16_t hann[JITTER_FFT_SIZE];       /* Q15 */
+
+/*--- Double buffer, filled by the measure task ---*/
+static int16_t blocks[2][JITTER_FFT_SIZE];
+static int      fill;
+static int      fillCount;
+static float    blockDpsPerLsb[2];
+static volatile int8_t readyBlock = -1;     /* block handed to the analysis task, -1 if none */
+static volatile bool runRequest;
+static volatile bool resetRequest;
+
+/*--- Analysis task ---*/
+static int32_t re[JITTER_FFT_SIZE];
+static int32_t im[JITTER_FFT_SIZE];
+static float   power[JITTER_BINS];          /* averaged power, (deg/s)^2 */
+static uint32_t powerBlocks;
+
+static jitter_result_t result;
+
+/**
+ *	@fn 		static void jitter_analyse(const int16_t *block, float dpsPerLsb)
+ *  @brief		Spectrum of a block, averaged power and results
+ *	@param[in]	block : gyro Y samples
+ *	@param[in]	dpsPerLsb : gyro sensitivity of the block
+ *	@return		void
+ *
+ */
+static void jitter_analyse(const int16_t *block, float dpsPerLsb)
+{
+	/*--- Mean removed, windowed ---*/
+	int32_t mean = 0;
+	for(int i = 0; i < JITTER_FFT_SIZE; i++)
+		mean += block[i];
+	mean /= JITTER_FFT_SIZE;
+
+	for(int i = 0; i < JITTER_FFT_SIZE; i++){
+		int32_t x = block[i] - mean;
+		if(x > INT16_MAX) x = INT16_MAX;
+		else if(x < INT16_MIN) x = INT16_MIN;
+		re[i] = ((x * hann[i]) >> 15) << JITTER_INPUT_SHIFT;
+		im[i] = 0;
+	}
+
+	fft_q15(re, im, JITTER_FFT_SIZE, cosTable, sinTable);
+
+	/*--- Averaged one sided power in (deg/s)^2 ---*/
+	if(resetRequest){
+		resetRequest = false;
+		memset(power, 0, sizeof(power));
+		powerBlocks = 0;
+	}
+	float scale = dpsPerLsb / (1 << JITTER_INPUT_SHIFT);
+	powerBlocks++;
+	for(int k = 0; k < JITTER_BINS; k++){
+		float xr = re[k] * scale, xi = im[k] * scale;
+		power[k] += ((xr * xr + xi * xi) - power[k]) / powerBlocks;
+	}
+
+	/*--- Band rms : one sided sum, window power corrected ---*/
+	jitter_result_t r = {};
+	float binHz = (float)JITTER_SAMPLE_HZ / JITTER_FFT_SIZE;
+	float total = 0.0f;
+	for(int k = 1; k < JITTER_BINS; k++){
+		float f = k * binHz;
+		float p = 2.0f * power[k] / JITTER_HANN_POWER;
+		if(f < bandHz[0])
+			continue;
+		total += p;
+		for(int b = 0; b < JITTER_BANDS; b++){
+			if(f >= bandHz[b] && f < bandHz[b + 1])
+				r.bandRmsDps[b] += p;
+		}
+	}
+	r.rmsDps = sqrtf(total);
+	for(int b = 0; b < JITTER_BANDS; b++)
+		r.bandRmsDps[b] = sqrtf(r.bandRmsDps[b]);
+
+	/*--- Strongest local maxima ---*/
+	for(int k = (int)ceilf(bandHz[0] / binHz); k < JITTER_BINS - 1; k++){
+		if(k < 1 || power[k] <= power[k - 1] || power[k] < power[k + 1])
+			continue;
+		/*--- Sine amplitude from the power of the main lobe, no scalloping loss between two bins ---*/
+		float amplitude = sqrtf(2.0f * 2.0f * (power[k - 1] + power[k] + power[k + 1]) / JITTER_HANN_POWER);
+		for(int p = 0; p < JITTER_PEAKS; p++){
+			if(amplitude > r.peaks[p].amplitudeDps){
+				memmove(&r.peaks[p + 1], &r.peaks[p], (JITTER_PEAKS - 1 - p) * sizeof(jitter_peak_t));
+				float m0 = sqrtf(power[k - 1]), m1 = sqrtf(power[k]), m2 = sqrtf(power[k + 1]);
+				float d = m0 - 2.0f * m1 + m2;
+				float delta = d != 0.0f ? 0.5f * (m0 - m2) / d : 0.0f;
+				r.peaks[p].frequencyHz = (k + delta) * binHz;
+				r.peaks[p].amplitudeDps = amplitude;
+				break;
+			}
+		}
+	}
+
+	taskENTER_CRITICAL(&resultLock);
+	r.blocks = powerBlocks;
+	r.overruns = result.overruns;
+	r.fifoOverflows = result.fifoOverflows;
+	result = r;
+	taskEXIT_CRITICAL(&resultLock);
+
+} /* End jitter_analyse() */
+
+/**
+ *	@fn 		static void task_jitter(void *ignore)
+ *  @brief		Background analysis of the blocks handed by jitter_push()
+ *
+ */
+static void task_jitter(void *ignore)
+{
+	while(1){
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		int8_t block = readyBlock;
+		if(block < 0)
+			continue;
+		jitter_analyse(blocks[block], blockDpsPerLsb[block]);
+		readyBlock = -1;
+	}
+
+} /* End task_jitter() */
+
+/**
+ *	@fn 		void jitter_init(void)
+ *  @brief		Tables and analysis task, called once by the measure task
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void jitter_init(void)
+{
+	fft_q15_twiddles(cosTable, sinTable, JITTER_FFT_SIZE);
+	for(int i = 0; i < JITTER_FFT_SIZE; i++)
+		hann[i] = (int16_t)lrintf((0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / JITTER_FFT_SIZE)) * 32767.0f);
+
+	/*--- Below the measure task, the FFT of a block takes a few ms ---*/
+	if(xTaskCreate(&task_jitter, "jitter_task", 3072, NULL, 2, &jitterTask) != pdPASS)
+		ESP_LOGE(tag, "jitter task not created");
+
+} /* End jitter_init() */
+
+/**
+ *	@fn 		void jitter_run(bool run)
+ *  @brief		Start or stop the analysis, taken into account by the measure task at its next cycle
+ *
+ */
+void jitter_run(bool run)
+{
+	runRequest = run;
+
+} /* End jitter_run() */
+
+/**
+ *	@fn 		bool jitter_requested(void)
+ *  @brief		Analysis requested through the HTTP API
+ *
+ */
+bool jitter_requested(void)
+{
+	return runRequest && jitterTask != NULL;
+
+} /* End jitter_requested() */
+
+/**
+ *	@fn 		void jitter_reset(void)
+ *  @brief		New analysis : empty block, averages and counters cleared
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+void jitter_reset(void)
+{
+	fillCount = 0;
+	resetRequest = true;
+
+	taskENTER_CRITICAL(&resultLock);
+	memset(&result, 0, sizeof(result));
+	taskEXIT_CRITICAL(&resultLock);
+
+} /* End jitter_reset() */
+
+/**
+ *	@fn 		void jitter_push(const int16_t *gy, int count, float dpsPerLsb)
+ *  @brief		Gyro Y samples from the FIFO, called by the measure task
+ *	@param[in]	gy : raw samples
+ *	@param[in]	count : number of samples
+ *	@param[in]	dpsPerLsb : gyro sensitivity (range of the acquisition profile)
+ *	@return		void
+ *
+ */
+void jitter_push(const int16_t *gy, int count, float dpsPerLsb)
+{
+	for(int i = 0; i < count; i++){
+		blocks[fill][fillCount++] = gy[i];
+		if(fillCount < JITTER_FFT_SIZE)
+			continue;
+
+		fillCount = 0;
+		if(readyBlock >= 0){
+			/*--- Analysis still busy : this block is dropped and filled again ---*/
+			taskENTER_CRITICAL(&resultLock);
+			result.overruns++;
+			taskEXIT_CRITICAL(&resultLock);
+			continue;
+		}
+		blockDpsPerLsb[fill] = dpsPerLsb;
+		readyBlock = fill;
+		fill ^= 1;
+		xTaskNotifyGive(jitterTask);
+	}
+
+} /* End jitter_push() */
+
+/**
+ *	@fn 		void jitter_fifo_overflow(void)
+ *  @brief		MPU6050 FIFO overflow, the current block is restarted
+ *
+ */
+void jitter_fifo_overflow(void)
+{
+	fillCount = 0;
+
+	taskENTER_CRITICAL(&resultLock);
+	result.fifoOverflows++;
+	taskEXIT_CRITICAL(&resultLock);
+
+} /* End jitter_fifo_overflow() */
+
+/**
+ *	@fn 		void jitter_read_error(void)
+ *  @brief		FIFO bytes lost on the bus, the current block is dropped (overrun) and restarted
+ *
+ */
+void jitter_read_error(void)
+{
+	fillCount = 0;
+
+	taskENTER_CRITICAL(&resultLock);
+	result.overruns++;
+	taskEXIT_CRITICAL(&resultLock);
+
+} /* End jitter_read_error() */
+
+/**
+ *	@fn 		void jitter_result(jitter_result_t *out)
+ *  @brief		Results of the analysis since the start
+ *	@param[out]	out : results
+ *	@return		void
+ *
+ */
+void jitter_result(jitter_result_t *out)
+{
+	taskENTER_CRITICAL(&resultLock);
+	*out = result;
+	taskEXIT_CRITICAL(&resultLock);
+
+} /* End jitter_result() */
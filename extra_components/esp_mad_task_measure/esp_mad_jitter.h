@@ -0,0 +1,67 @@
+/**
+ * @file      esp_mad_jitter.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the servo jitter / flutter analysis of the esp_mad_task_measure component.
+ *
+ * @details   The measure task pushes the gyro Y samples read from the MPU6050 FIFO at 1 kHz. They
+ *            are gathered in two blocks : one is filled while the other one is analysed by a
+ *            background task (fixed-point FFT). This header is also included by the C http server.
+ *
+ */
+
+#ifndef _ESP_MAD_JITTER_H_
+
+#define _ESP_MAD_JITTER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define JITTER_FFT_LOG2         8                       /* 256 points : 3.9 Hz bins, 256 ms blocks at 1 kHz */
+	#define JITTER_FFT_SIZE         (1 << JITTER_FFT_LOG2)
+	#define JITTER_SAMPLE_HZ        1000                    /* MPU6050 sample rate during the analysis          */
+	#define JITTER_PEAKS            3                       /* dominant frequencies reported                    */
+	#define JITTER_BANDS            3
+	#define JITTER_BAND_HZ          { 4, 20, 100, 500 }     /* band limits : servo motion, jitter, buzz/flutter */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		float frequencyHz;
+		float amplitudeDps;                     /* sine amplitude in deg/s                        */
+	} jitter_peak_t;
+
+	typedef struct {
+		uint32_t blocks;                        /* blocks analysed since the start                */
+		uint32_t overruns;                      /* blocks dropped : analysis busy, FIFO bus error */
+		uint32_t fifoOverflows;                 /* MPU6050 FIFO full, samples lost                */
+		float    rmsDps;                        /* gyro rms above the first band limit            */
+		float    bandRmsDps[JITTER_BANDS];
+		jitter_peak_t peaks[JITTER_PEAKS];      /* strongest first, 0 Hz if none                  */
+	} jitter_result_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void jitter_init(void);
+	void jitter_run(bool run);
+	bool jitter_requested(void);
+	void jitter_reset(void);
+	void jitter_push(const int16_t *gy, int count, float dpsPerLsb);
+	void jitter_fifo_overflow(void);
+	void jitter_read_error(void);
+	void jitter_result(jitter_result_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
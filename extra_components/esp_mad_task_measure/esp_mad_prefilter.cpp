@@ -0,0 +1,102 @@
+/**
+ * @file      esp_mad_prefilter.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Accelero prefilter : median and magnitude gate
+ *
+ * @details   A bump on the bench or the vibration of a running motor puts short spikes on the
+ *            accelero; through atan2() they corrupt the angle for seconds through the filter state.
+ *
+ *              - median of the last PREFILTER_MEDIAN samples of each axis : a spike shorter than
+ *                half the window never reaches the filter (the accelero path gets 2 samples of
+ *                delay, the gyro path none)
+ *              - magnitude gate : the accelero only measures the gravity direction when |a| is
+ *                close to 1 g; otherwise (shock, surface acceleration) the sample is rejected and
+ *                the filter runs on the gyro alone
+ *
+ *            Integer only : samples in 2 g range LSB, |a|^2 compared in 64 bits to constant bounds.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <string.h>
+#include "esp_mad_prefilter.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define GATE_LOW    ((int64_t)PREFILTER_LSB_PER_G * (1000 - PREFILTER_GATE_MG) / 1000)
+#define GATE_HIGH   ((int64_t)PREFILTER_LSB_PER_G * (1000 + PREFILTER_GATE_MG) / 1000)
+
+/**
+ *	@fn 		static int32_t median(const int32_t *values, int count)
+ *  @brief		Median by insertion sort of a copy, count <= PREFILTER_MEDIAN
+ *
+ */
+static int32_t median(const int32_t *values, int count)
+{
+	int32_t sorted[PREFILTER_MEDIAN];
+
+	for(int i = 0; i < count; i++){
+		int32_t v = values[i];
+		int j = i;
+		for(; j > 0 && sorted[j - 1] > v; j--)
+			sorted[j] = sorted[j - 1];
+		sorted[j] = v;
+	}
+	return sorted[count / 2];
+
+} /* End median() */
+
+/**
+ *	@fn 		void accel_prefilter_reset(accel_prefilter_t *f)
+ *  @brief		Empty history, counters cleared
+ *
+ */
+void accel_prefilter_reset(accel_prefilter_t *f)
+{
+	memset(f, 0, sizeof(*f));
+
+} /* End accel_prefilter_reset() */
+
+/**
+ *	@fn 		bool accel_prefilter(accel_prefilter_t *f, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale)
+ *  @brief		Median of each axis in place, then magnitude gate
+ *	@param[in]	f : prefilter of the MPU6050
+ *	@param[in,out]	ax, ay, az : raw accelero, replaced by their median
+ *	@param[in]	accelScale : raw x accelScale = 2 g range LSB
+ *	@return		true if the accelero can be used by the fusion filter
+ *
+ */
+bool accel_prefilter(accel_prefilter_t *f, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale)
+{
+	int16_t *axis[3] = {ax, ay, az};
+	int32_t filtered[3];
+	bool spike = false;
+
+	if(f->count < PREFILTER_MEDIAN)
+		f->count++;
+
+	for(int i = 0; i < 3; i++){
+		int32_t raw = (int32_t)*axis[i] * accelScale;
+		f->history[i][f->head] = raw;
+		filtered[i] = median(f->history[i], f->count);
+		if(raw - filtered[i] > PREFILTER_SPIKE_LSB || filtered[i] - raw > PREFILTER_SPIKE_LSB)
+			spike = true;
+		*axis[i] = (int16_t)(filtered[i] / accelScale);
+	}
+	if(++f->head == PREFILTER_MEDIAN)
+		f->head = 0;
+	if(spike)
+		f->spikes++;
+
+	int64_t magnitude2 = (int64_t)filtered[0] * filtered[0] + (int64_t)filtered[1] * filtered[1] + (int64_t)filtered[2] * filtered[2];
+	if(magnitude2 < GATE_LOW * GATE_LOW || magnitude2 > GATE_HIGH * GATE_HIGH){
+		f->gated++;
+		return false;
+	}
+	return true;
+
+} /* End accel_prefilter() */
@@ -0,0 +1,43 @@
+/**
+ * @file      esp_mad_prefilter.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the accelero prefilter of the esp_mad_task_measure component.
+ *
+ * @details   Streaming median per axis and gravity magnitude gate on the raw accelero, in integer
+ *            arithmetic and constant cost per sample, before the fusion filter.
+ *
+ */
+
+#ifndef _ESP_MAD_PREFILTER_H_
+
+#define _ESP_MAD_PREFILTER_H_
+
+#include <stdint.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define PREFILTER_MEDIAN        5           /* median window, removes spikes up to 2 samples long       */
+	#define PREFILTER_LSB_PER_G     16384       /* 2 g range                                                */
+	#define PREFILTER_SPIKE_LSB     820         /* raw farther than 50 mg from the median : counted spike   */
+	#define PREFILTER_GATE_MG       150         /* |a| farther than 150 mg from 1 g : accelero not used     */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		int32_t  history[3][PREFILTER_MEDIAN];  /* 2 g range LSB                                  */
+		uint8_t  head;
+		uint8_t  count;
+		uint32_t spikes;                        /* samples with an axis replaced by its median   */
+		uint32_t gated;                         /* samples rejected by the magnitude gate        */
+	} accel_prefilter_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void accel_prefilter_reset(accel_prefilter_t *f);
+	bool accel_prefilter(accel_prefilter_t *f, int16_t *ax, int16_t *ay, int16_t *az, uint8_t accelScale);
+
+#endif
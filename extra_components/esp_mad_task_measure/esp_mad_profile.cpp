@@ -0,0 +1,143 @@
+/**
+ * @file      esp_mad_profile.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Acquisition profiles of the MPU6050
+ *
+ * @details   Sample rate and DLPF bandwidth are chosen together : the bandwidth stays under half
+ *            the sample rate. The loop period is a multiple of the FreeRTOS tick (10 ms).
+ *
+ *              - precision : static measure, 50 Hz and 10 Hz bandwidth, lowest noise
+ *              - standard  : 100 Hz and 44 Hz bandwidth, default
+ *              - servo     : 100 Hz, 94 Hz bandwidth (3 ms delay), 1000 deg/s and 4 g for fast sweeps
+ *              - low_power : 20 Hz, 5 Hz bandwidth, the CPU sleeps between the samples
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <esp_log.h>
+#include <esp_err.h>
+#include <nvs.h>
+#include <string.h>
+#include "MPU6050.h"
+#include "esp_mad_profile.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define PROFILE_NVS_NAMESPACE   "esp_mad"
+#define PROFILE_NVS_KEY         "profile"
+
+static const acquisition_profile_t profiles[] = {
+	/* name          rateDiv  dlpfMode               gyroRange             accelRange            loop */
+	{ "precision",   19,      MPU6050_DLPF_BW_10,    MPU6050_GYRO_FS_250,  MPU6050_ACCEL_FS_2,   20 },
+	{ "standard",    9,       MPU6050_DLPF_BW_42,    MPU6050_GYRO_FS_250,  MPU6050_ACCEL_FS_2,   10 },
+	{ "servo",       9,       MPU6050_DLPF_BW_98,    MPU6050_GYRO_FS_1000, MPU6050_ACCEL_FS_4,   10 },
+	{ "low_power",   49,      MPU6050_DLPF_BW_5,     MPU6050_GYRO_FS_250,  MPU6050_ACCEL_FS_2,   50 },
+};
+
+#define PROFILE_COUNT   (int)(sizeof(profiles) / sizeof(profiles[0]))
+
+static const char tag[] = "profile->";
+
+/**
+ *	@fn 		int acquisition_profile_count(void)
+ *  @brief		Number of profiles
+ *
+ */
+int acquisition_profile_count(void)
+{
+	return PROFILE_COUNT;
+
+} /* End acquisition_profile_count() */
+
+/**
+ *	@fn 		const acquisition_profile_t *acquisition_profile_get(int index)
+ *  @brief		Profile description
+ *	@param[in]	index : 0 to acquisition_profile_count() - 1
+ *	@return		profile, the default one if index is out of range
+ *
+ */
+const acquisition_profile_t *acquisition_profile_get(int index)
+{
+	if(index < 0 || index >= PROFILE_COUNT)
+		index = PROFILE_DEFAULT;
+	return &profiles[index];
+
+} /* End acquisition_profile_get() */
+
+/**
+ *	@fn 		int acquisition_profile_find(const char *name)
+ *  @brief		Profile index from its name
+ *	@param[in]	name : profile name
+ *	@return		index or -1 if unknown
+ *
+ */
+int acquisition_profile_find(const char *name)
+{
+	for(int i = 0; i < PROFILE_COUNT; i++){
+		if(strcmp(profiles[i].name, name) == 0)
+			return i;
+	}
+	return -1;
+
+} /* End acquisition_profile_find() */
+
+/**
+ *	@fn 		int acquisition_profile_load(void)
+ *  @brief		Profile saved in NVS
+ *	@param[in]	void
+ *	@return		index, PROFILE_DEFAULT if none is saved
+ *
+ */
+int acquisition_profile_load(void)
+{
+	nvs_handle_t handle;
+	uint8_t index = PROFILE_DEFAULT;
+	esp_err_t err;
+
+	/*--- NOT_FOUND : nothing saved yet, the namespace is created by the first save ---*/
+	if((err = nvs_open(PROFILE_NVS_NAMESPACE, NVS_READONLY, &handle)) == ESP_OK){
+		err = nvs_get_u8(handle, PROFILE_NVS_KEY, &index);
+		if(err == ESP_OK && index >= PROFILE_COUNT)
+			err = ESP_ERR_INVALID_STATE;
+		if(err != ESP_OK)
+			index = PROFILE_DEFAULT;
+		nvs_close(handle);
+	}
+	else if(err != ESP_ERR_NVS_NOT_FOUND)
+		ESP_LOGE(tag, "nvs_open failed (%s)", esp_err_to_name(err));
+
+	ESP_LOGI(tag, "profile %s%s", profiles[index].name, err == ESP_OK ? " restored from NVS" : "");
+	return index;
+
+} /* End acquisition_profile_load() */
+
+/**
+ *	@fn 		void acquisition_profile_save(int index)
+ *  @brief		Save the profile in NVS
+ *	@param[in]	index : profile index
+ *	@return		void
+ *
+ */
+void acquisition_profile_save(int index)
+{
+	nvs_handle_t handle;
+	esp_err_t err;
+
+	if((err = nvs_open(PROFILE_NVS_NAMESPACE, NVS_READWRITE, &handle)) != ESP_OK){
+		ESP_LOGW(tag, "nvs_open failed (%s)", esp_err_to_name(err));
+		return;
+	}
+
+	err = nvs_set_u8(handle, PROFILE_NVS_KEY, (uint8_t)index);
+	if(err == ESP_OK)
+		err = nvs_commit(handle);
+	nvs_close(handle);
+
+	if(err != ESP_OK)
+		ESP_LOGW(tag, "profile not saved (%s)", esp_err_to_name(err));
+
+} /* End acquisition_profile_save() */
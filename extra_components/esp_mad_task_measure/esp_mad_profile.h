@@ -0,0 +1,54 @@
+/**
+ * @file      esp_mad_profile.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the acquisition profiles of the esp_mad_task_measure component.
+ *
+ * @details   A profile sets together the MPU6050 output data rate, digital low-pass filter,
+ *            full-scale ranges and the period of the measure loop. The profile is selected
+ *            through g_profileRequest (HTTP API) and persisted in NVS. This header is also
+ *            included by the C http server.
+ *
+ */
+
+#ifndef _ESP_MAD_PROFILE_H_
+
+#define _ESP_MAD_PROFILE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		const char *name;
+		uint8_t  rateDiv;               /* sample rate = 1 kHz / (1 + rateDiv), DLPF enabled    */
+		uint8_t  dlpfMode;              /* MPU6050_DLPF_BW_xxx                                  */
+		uint8_t  gyroRange;             /* MPU6050_GYRO_FS_xxx                                  */
+		uint8_t  accelRange;            /* MPU6050_ACCEL_FS_xxx                                 */
+		uint16_t loopPeriodMs;          /* period of the measure loop                           */
+	} acquisition_profile_t;
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define PROFILE_DEFAULT     1       /* "standard" */
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	int acquisition_profile_count(void);
+	const acquisition_profile_t *acquisition_profile_get(int index);
+	int acquisition_profile_find(const char *name);
+	int acquisition_profile_load(void);
+	void acquisition_profile_save(int index);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
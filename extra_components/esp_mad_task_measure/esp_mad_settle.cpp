@@ -0,0 +1,118 @@
+/**
+ * @file      esp_mad_settle.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Settled reading detector
+ *
+ * @details   Welford update on a sliding window : the new sample replaces the oldest one,
+ *
+ *              mean' = mean + (x - old) / N
+ *              M2'   = M2 + (x - old) * (x - mean' + old - mean)
+ *
+ *            so the cost does not depend on the window length. The rounding errors of M2 are
+ *            cleared by an exact recomputation each time the window wraps around.
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <math.h>
+#include <string.h>
+#include "esp_mad_settle.h"
+
+/**
+ *	@fn 		static void settle_recompute(settle_t *s)
+ *  @brief		Exact mean and M2 of the full window
+ *
+ */
+static void settle_recompute(settle_t *s)
+{
+	float mean = 0.0f, m2 = 0.0f;
+
+	for(int i = 0; i < SETTLE_WINDOW; i++)
+		mean += s->window[i];
+	mean /= SETTLE_WINDOW;
+	for(int i = 0; i < SETTLE_WINDOW; i++)
+		m2 += (s->window[i] - mean) * (s->window[i] - mean);
+
+	s->mean = mean;
+	s->m2 = m2;
+
+} /* End settle_recompute() */
+
+/**
+ *	@fn 		void settle_reset(settle_t *s)
+ *  @brief		Empty window
+ *
+ */
+void settle_reset(settle_t *s)
+{
+	memset(s, 0, sizeof(*s));
+
+} /* End settle_reset() */
+
+/**
+ *	@fn 		bool settle_update(settle_t *s, float x)
+ *  @brief		New sample
+ *	@param[in]	s : detector
+ *	@param[in]	x : angle in degree
+ *	@return		settled
+ *
+ */
+bool settle_update(settle_t *s, float x)
+{
+	if(s->count < SETTLE_WINDOW){
+		/*--- Filling : plain Welford ---*/
+		s->window[s->head] = x;
+		s->count++;
+		float delta = x - s->mean;
+		s->mean += delta / s->count;
+		s->m2 += delta * (x - s->mean);
+	}
+	else{
+		float old = s->window[s->head];
+		float mean = s->mean;
+		s->window[s->head] = x;
+		s->mean += (x - old) / SETTLE_WINDOW;
+		s->m2 += (x - old) * (x - s->mean + old - mean);
+		if(s->m2 < 0.0f)
+			s->m2 = 0.0f;
+	}
+
+	if(++s->head == SETTLE_WINDOW){
+		s->head = 0;
+		settle_recompute(s);
+	}
+
+	if(s->count < SETTLE_WINDOW)
+		s->settled = false;
+	else{
+		float std = settle_std(s);
+		s->settled = s->settled ? std < SETTLE_STD_EXIT : std < SETTLE_STD_MAX;
+	}
+	return s->settled;
+
+} /* End settle_update() */
+
+/**
+ *	@fn 		float settle_std(const settle_t *s)
+ *  @brief		Standard deviation of the window in degree
+ *
+ */
+float settle_std(const settle_t *s)
+{
+	return s->count > 1 ? sqrtf(s->m2 / (s->count - 1)) : 0.0f;
+
+} /* End settle_std() */
+
+/**
+ *	@fn 		float settle_confidence(const settle_t *s)
+ *  @brief		95 % confidence half interval of the mean in degree, 2 * std / sqrt(N)
+ *
+ */
+float settle_confidence(const settle_t *s)
+{
+	return s->count > 0 ? 2.0f * settle_std(s) / sqrtf(s->count) : 0.0f;
+
+} /* End settle_confidence() */
@@ -0,0 +1,46 @@
+/**
+ * @file      esp_mad_settle.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the settled reading detector of the esp_mad_task_measure component.
+ *
+ * @details   Running mean and variance of the angle over a sliding window (Welford, O(1) per
+ *            sample). The reading is settled when the window is full and its standard deviation
+ *            is small; the window mean is then the displayed angle.
+ *
+ */
+
+#ifndef _ESP_MAD_SETTLE_H_
+
+#define _ESP_MAD_SETTLE_H_
+
+#include <stdint.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define SETTLE_WINDOW           50          /* samples, 0.5 s at 100 Hz                                  */
+	#define SETTLE_STD_MAX          0.05f       /* standard deviation in degree under which it is settled    */
+	#define SETTLE_STD_EXIT         0.10f       /* ...and over which it is not anymore (hysteresis)          */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct {
+		float    window[SETTLE_WINDOW];
+		uint16_t head;
+		uint16_t count;
+		float    mean;
+		float    m2;                            /* sum of the squared deviations from the mean   */
+		bool     settled;
+	} settle_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void settle_reset(settle_t *s);
+	bool settle_update(settle_t *s, float x);
+	float settle_std(const settle_t *s);
+	float settle_confidence(const settle_t *s);
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * @file      esp_mad_sweep.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Servo sweep capture : throw trace, speed and overshoot of the first surface
+ *
+ * @details   The measure task feeds every sample of the first surface with sweep_update(). Armed, the
+ *            last SWEEP_PRETRIGGER samples are kept in a ring; the capture starts when the angular
+ *            speed (difference of two consecutive angles) reaches SWEEP_TRIGGER_DPS and ends after
+ *            SWEEP_END_MS without motion, or when the buffer is full. The metrics are then computed
+ *            once, the buffers are preallocated and frozen until the next arm.
+ *
+ *              - t0         : last sample before the speed crossed the trigger
+ *              - start      : mean angle of the pretrigger samples
+ *              - final      : mean angle over the last 100 ms
+ *              - t90        : t0 to 90 % of the step, interpolated between two samples
+ *              - overshoot  : largest angle beyond final, after t90
+ *              - settling   : t0 to the last return in the settling band around final
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <math.h>
+#include <esp_log.h>
+#include "esp_mad_sweep.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define SWEEP_FINAL_US      100000      /* final angle averaged over the last 100 ms */
+
+static const char tag[] = "sweep->";
+
+static volatile int8_t armRequest = -1;         /* from the http server, -1 if none              */
+static volatile sweep_state_t state = SWEEP_IDLE;
+
+static float    angles[SWEEP_MAX_SAMPLES];      /* degree                                        */
+static uint32_t times[SWEEP_MAX_SAMPLES];       /* us from the first recorded sample             */
+static int      count;
+static int      triggerIndex;                   /* t0 sample                                     */
+static int64_t  origin;
+static int64_t  quietSince;
+
+static float    ringAngle[SWEEP_PRETRIGGER];
+static int64_t  ringTime[SWEEP_PRETRIGGER];
+static int      ringCount;
+static int      ringHead;
+
+static bool     havePrevious;
+static float    previousAngle;
+static int64_t  previousTime;
+
+static sweep_result_t result;
+
+/**
+ *	@fn 		static void sweep_append(int64_t timestamp, float angle)
+ *  @brief		Record a sample
+ *
+ */
+static void sweep_append(int64_t timestamp, float angle)
+{
+	if(count == 0)
+		origin = timestamp;
+	angles[count] = angle;
+	times[count] = (uint32_t)(timestamp - origin);
+	count++;
+
+} /* End sweep_append() */
+
+/**
+ *	@fn 		static void sweep_analyse(void)
+ *  @brief		Throw metrics of the recorded samples
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+static void sweep_analyse(void)
+{
+	float t0 = times[triggerIndex];
+
+	/*--- Start and final angles ---*/
+	float start = angles[0];
+	if(triggerIndex > 0){
+		start = 0.0f;
+		for(int i = 0; i < triggerIndex; i++)
+			start += angles[i];
+		start /= triggerIndex;
+	}
+
+	float final = 0.0f;
+	int finalCount = 0;
+	for(int i = count - 1; i >= 0 && (finalCount == 0 || times[count - 1] - times[i] <= SWEEP_FINAL_US); i--){
+		final += angles[i];
+		finalCount++;
+	}
+	final /= finalCount;
+
+	float step = final - start;
+	float dir = step >= 0.0f ? 1.0f : -1.0f;
+	float magnitude = fabsf(step);
+
+	/*--- Peak speed, central difference ---*/
+	float peak = 0.0f;
+	for(int i = 1; i < count - 1; i++){
+		uint32_t dt = times[i + 1] - times[i - 1];
+		if(dt > 0){
+			float speed = fabsf(angles[i + 1] - angles[i - 1]) * 1e6f / dt;
+			if(speed > peak)
+				peak = speed;
+		}
+	}
+
+	/*--- Time to 90 % of the step ---*/
+	float target = 0.9f * magnitude;
+	int i90 = count - 1;
+	float t90 = times[count - 1];
+	for(int i = triggerIndex; i < count; i++){
+		float x = (angles[i] - start) * dir;
+		if(x >= target){
+			i90 = i;
+			t90 = times[i];
+			if(i > triggerIndex){
+				float xp = (angles[i - 1] - start) * dir;
+				if(x > xp)
+					t90 = times[i - 1] + (target - xp) / (x - xp) * (times[i] - times[i - 1]);
+			}
+			break;
+		}
+	}
+
+	/*--- Overshoot after t90 ---*/
+	float overshoot = 0.0f;
+	for(int i = i90; i < count; i++){
+		float x = (angles[i] - final) * dir;
+		if(x > overshoot)
+			overshoot = x;
+	}
+
+	/*--- Settling : last sample out of the band, the next one is back in ---*/
+	float band = fmaxf(magnitude * SWEEP_SETTLE_PERCENT / 100.0f, SWEEP_SETTLE_MIN_DEG);
+	float settling = t0;
+	for(int i = count - 1; i >= triggerIndex; i--){
+		if(fabsf(angles[i] - final) > band){
+			settling = times[i < count - 1 ? i + 1 : i];
+			break;
+		}
+	}
+
+	result.samples = count;
+	result.sampleMs = count > 1 ? times[count - 1] / 1000.0f / (count - 1) : 0.0f;
+	result.startDeg = start;
+	result.stepDeg = step;
+	result.peakSpeedDps = peak;
+	result.t90Ms = (t90 - t0) / 1000.0f;
+	result.overshootDeg = overshoot;
+	result.overshootPercent = magnitude > 0.0f ? overshoot * 100.0f / magnitude : 0.0f;
+	result.settlingMs = (settling - t0) / 1000.0f;
+
+	ESP_LOGI(tag, "step %.1f deg, %.0f deg/s, t90 %.0f ms, overshoot %.2f deg, settling %.0f ms",
+			 result.stepDeg, result.peakSpeedDps, result.t90Ms, result.overshootDeg, result.settlingMs);
+
+} /* End sweep_analyse() */
+
+/**
+ *	@fn 		void sweep_arm(bool arm)
+ *  @brief		Arm (or cancel) a capture, taken into account at the next sample
+ *	@param[in]	arm : true to arm, false to cancel
+ *	@return		void
+ *
+ */
+void sweep_arm(bool arm)
+{
+	armRequest = arm ? 1 : 0;
+
+} /* End sweep_arm() */
+
+/**
+ *	@fn 		bool sweep_busy(void)
+ *  @brief		A capture is requested, armed or recording : the measure must go on
+ *
+ */
+bool sweep_busy(void)
+{
+	return armRequest == 1 || state == SWEEP_ARMED || state == SWEEP_RECORDING;
+
+} /* End sweep_busy() */
+
+/**
+ *	@fn 		void sweep_update(int64_t timestamp, float angle)
+ *  @brief		New sample of the first surface, called by the measure task
+ *	@param[in]	timestamp : sample time in us
+ *	@param[in]	angle : surface angle in degree
+ *	@return		void
+ *
+ */
+void sweep_update(int64_t timestamp, float angle)
+{
+	int8_t request = armRequest;
+
+	if(request >= 0){
+		armRequest = -1;
+		state = request ? SWEEP_ARMED : SWEEP_IDLE;
+		count = ringCount = ringHead = 0;
+		havePrevious = false;
+	}
+
+	if(state != SWEEP_ARMED && state != SWEEP_RECORDING)
+		return;
+
+	float speed = 0.0f;
+	if(havePrevious && timestamp > previousTime)
+		speed = (angle - previousAngle) * 1e6f / (timestamp - previousTime);
+	havePrevious = true;
+	previousAngle = angle;
+	previousTime = timestamp;
+
+	if(state == SWEEP_ARMED){
+		if(fabsf(speed) >= SWEEP_TRIGGER_DPS && ringCount > 0){
+			/*--- Pretrigger samples first, oldest first; the last one is t0 ---*/
+			int oldest = (ringHead - ringCount + SWEEP_PRETRIGGER) % SWEEP_PRETRIGGER;
+			for(int i = 0; i < ringCount; i++){
+				int k = (oldest + i) % SWEEP_PRETRIGGER;
+				sweep_append(ringTime[k], ringAngle[k]);
+			}
+			triggerIndex = count - 1;
+			sweep_append(timestamp, angle);
+			quietSince = timestamp;
+			state = SWEEP_RECORDING;
+		}
+		else{
+			ringAngle[ringHead] = angle;
+			ringTime[ringHead] = timestamp;
+			ringHead = (ringHead + 1) % SWEEP_PRETRIGGER;
+			if(ringCount < SWEEP_PRETRIGGER)
+				ringCount++;
+		}
+		return;
+	}
+
+	sweep_append(timestamp, angle);
+	if(fabsf(speed) >= SWEEP_TRIGGER_DPS)
+		quietSince = timestamp;
+
+	if(count == SWEEP_MAX_SAMPLES || timestamp - quietSince >= SWEEP_END_MS * 1000LL){
+		sweep_analyse();
+		state = SWEEP_DONE;
+	}
+
+} /* End sweep_update() */
+
+/**
+ *	@fn 		sweep_state_t sweep_state(void)
+ *  @brief		State of the capture
+ *
+ */
+sweep_state_t sweep_state(void)
+{
+	return state;
+
+} /* End sweep_state() */
+
+/**
+ *	@fn 		bool sweep_result(sweep_result_t *out)
+ *  @brief		Metrics of the last capture
+ *	@param[out]	out : metrics
+ *	@return		false if no capture is done
+ *
+ */
+bool sweep_result(sweep_result_t *out)
+{
+	if(state != SWEEP_DONE)
+		return false;
+	*out = result;
+	return true;
+
+} /* End sweep_result() */
+
+/**
+ *	@fn 		int sweep_trace(float *angle, int maxPoints, float *stepMs)
+ *  @brief		Decimated trace of the last capture, angles from the start angle
+ *	@param[out]	angle : maxPoints angles in degree
+ *	@param[in]	maxPoints : size of angle
+ *	@param[out]	stepMs : time between two points
+ *	@return		number of points, 0 if no capture is done
+ *
+ */
+int sweep_trace(float *angle, int maxPoints, float *stepMs)
+{
+	if(state != SWEEP_DONE || maxPoints <= 0)
+		return 0;
+
+	int stride = (count + maxPoints - 1) / maxPoints;
+	int points = 0;
+
+	for(int i = 0; i < count; i += stride)
+		angle[points++] = angles[i] - result.startDeg;
+	*stepMs = stride * result.sampleMs;
+	return points;
+
+} /* End sweep_trace() */
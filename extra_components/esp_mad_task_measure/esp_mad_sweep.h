@@ -0,0 +1,72 @@
+/**
+ * @file      esp_mad_sweep.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the servo sweep capture of the esp_mad_task_measure component.
+ *
+ * @details   Once armed, the capture is triggered by the angular speed of the first surface and
+ *            records its angle at the measure loop rate. The throw metrics are computed when the
+ *            surface is settled or the buffer is full. This header is also included by the C http
+ *            server.
+ *
+ */
+
+#ifndef _ESP_MAD_SWEEP_H_
+
+#define _ESP_MAD_SWEEP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define SWEEP_MAX_SAMPLES       400         /* 4 s at 100 Hz                                              */
+	#define SWEEP_PRETRIGGER        10          /* samples kept before the trigger                            */
+	#define SWEEP_TRIGGER_DPS       30.0f       /* angular speed starting the capture                         */
+	#define SWEEP_END_MS            300         /* capture ends when the speed stays under the trigger so long */
+	#define SWEEP_SETTLE_PERCENT    2.0f        /* settling band in % of the step...                          */
+	#define SWEEP_SETTLE_MIN_DEG    0.2f        /* ...but not narrower than the angle noise                   */
+	#define SWEEP_TRACE_POINTS      100         /* decimated trace served to the UI                           */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef enum {
+		SWEEP_IDLE,
+		SWEEP_ARMED,
+		SWEEP_RECORDING,
+		SWEEP_DONE
+	} sweep_state_t;
+
+	typedef struct {
+		uint16_t samples;               /* samples recorded                                       */
+		float    sampleMs;              /* mean sample period                                     */
+		float    startDeg;              /* angle before the motion                                */
+		float    stepDeg;               /* final angle - start angle                              */
+		float    peakSpeedDps;          /* peak angular speed in deg/s                            */
+		float    t90Ms;                 /* trigger to 90 % of the step                            */
+		float    overshootDeg;          /* beyond the final angle, in the direction of the step   */
+		float    overshootPercent;      /* overshoot in % of the step                             */
+		float    settlingMs;            /* trigger to the last exit of the settling band          */
+	} sweep_result_t;
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	void sweep_arm(bool arm);
+	bool sweep_busy(void);
+	void sweep_update(int64_t timestamp, float angle);
+	sweep_state_t sweep_state(void);
+	bool sweep_result(sweep_result_t *out);
+	int sweep_trace(float *angle, int maxPoints, float *stepMs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
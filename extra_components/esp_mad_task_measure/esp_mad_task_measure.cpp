@@ -23,168 +23,835 @@
 #include "I2Cdev.h"
 #include "MPU6050_6Axis_MotionApps20.h"
 #include "esp_mad_task_measure.h"
+#include "esp_mad_gyro_tbias.h"
+#include "esp_mad_fusion.h"
+#include "esp_mad_attitude.h"
+#include "esp_mad_profile.h"
+#include "esp_mad_sweep.h"
+#include "esp_mad_jitter.h"
+#include "esp_mad_settle.h"
+#include "esp_mad_prefilter.h"
+#include "esp_mad_accel_calib.h"
+#include "esp_mad_target.h"
+#include <esp_timer.h>
+#include <esp_pm.h>
+#include <nvs.h>
 #include "sdkconfig.h"
 #include <driver/i2c.h>
+#include <driver/gpio.h>
 #include "math.h"
+#include <string.h>
 #include <Esp_mad.h>
 #include <Esp_mad_Globals_Variables.h>
 
 /*-----------------------------------------
  *-            LOCALS VARIABLES        
  *-----------------------------------------*/
-int16_t ax, ay, az;                       // raw measure
-int16_t gx, gy, gz;
-uint8_t Accel_range;
-uint8_t Gyro_range;
+static const char TAG[] = "task_measure->";
 
-//Change this 3 variables if you want to fine tune to your needs.
-int buffersize=1000;     //Amount of readings used to average, make it higher to get more precision but algorithm will be slower  (default:1000)
-int acel_deadzone=8;     //Acelerometer error allowed, make it lower to get more precision, but algorithm may not converge  (default:8)
-int giro_deadzone=1;     //Giro error allowed, make it lower to get more precision, but algorithm may not converge  (default:1)
+/*--- Stillness detection for the online gyro bias estimation (zero-velocity update). The surface is  ---*/
+/*--- considered static when, over a window, the accelero standard deviation and every gyro deviation ---*/
+/*--- from the current bias stay under their thresholds. Units are raw LSB (2g / 250 deg/s ranges).   ---*/
+#define ZUPT_WINDOW         50      /* samples per window, 0.5 s at 100 Hz                       */
+#define ZUPT_ACCEL_STD_MAX  80      /* accelero standard deviation per axis, ~5 mg               */
+#define ZUPT_GYRO_MAX       131     /* gyro deviation from the bias per axis, 1 deg/s            */
+#define ZUPT_BIAS_GAIN      0.1f    /* weight of a still window in the bias estimate             */
 
-int mean_ax,mean_ay,mean_az,mean_gx,mean_gy,mean_gz,state=0;
-int ax_offset,ay_offset,az_offset,gx_offset,gy_offset,gz_offset;
+typedef struct {
+	int32_t  accelSum[3];
+	int64_t  accelSumSq[3];
+	int32_t  gyroSum[3];
+	bool     moving;
+	uint16_t count;
+} zupt_window_t;
 
-MPU6050 mpu = MPU6050();
+#define TBIAS_PERIOD        100     /* samples between two temperature model updates, 1 s       */
+
+/*--- Calibration of the MPU6050 offset registers, at boot and on request. It runs in the measure loop ---*/
+/*--- on the samples of the acquisition profile : each MPU6050 is averaged over a window where it stays ---*/
+/*--- still (same thresholds as the stillness detection), and the new offsets bring the means to 0 (ax, ---*/
+/*--- ay, gyro) and 1 g (az) : the mounting position reads flat. The means are read with the current    ---*/
+/*--- offsets, so the new ones are found in one step. A window with motion starts again.                ---*/
+#define CALIB_DISCARD       10      /* samples dropped at the start of a window                  */
+#define CALIB_SAMPLES       300     /* samples averaged, 3 s at 100 Hz                           */
+#define CALIB_ACCEL_STEP    8       /* 2 g range LSB per XA_OFFS LSB (16 g range)                */
+#define CALIB_GYRO_STEP     4       /* 250 deg/s range LSB per XG_OFFS_USR LSB (1000 deg/s range) */
+
+typedef struct {
+	int32_t  sum[6];                /* ax ay az gx gy gz, 2 g / 250 deg/s range LSB               */
+	int64_t  sumSq[6];
+	uint16_t count;
+	bool     done;
+	int      offset[6];             /* offsets to write once every window is done                */
+} calib_window_t;
+
+/*--- One MPU6050 of the bus and its processing state ---*/
+struct measure_sensor {
+	MPU6050  mpu;
+	uint8_t  address;
+	int16_t  ax, ay, az;                  // raw measure, accelero corrected by accelCal once read
+	int16_t  gx, gy, gz;
+	int16_t  temp;                        // raw die temperature, comes with the motion burst
+	int64_t  timestamp;                   // time of the last sample in us
+	uint8_t  gyroScale;                   // raw gyro x gyroScale = 250 deg/s range LSB (131 LSB/deg/s)
+	uint8_t  accelScale;                  // raw accelero x accelScale = 2 g range LSB
+	bool     sampleOk;
+
+	int ax_offset,ay_offset,az_offset,gx_offset,gy_offset,gz_offset;
+	calib_window_t calib;                 // window of the running calibration
+
+	zupt_window_t zupt;
+	bool     still;
+	float    gyroBias[3];                 // residual gyro bias (LSB) not predicted by the temperature model
+	float    modelBias[3];                // gyro bias (LSB) predicted by the temperature model
+	float    temperature;                 // die temperature in °C
+	gyro_tbias_t tbias;
+	uint32_t sampleCount;
+	accel_prefilter_t prefilter;          // accelero median and magnitude gate before the fusion
+	accel_cal_t accelCal;                 // six-position accelero correction, not valid if none
+
+#if ESP_MAD_ATTITUDE_3D
+	Attitude attitude;
+#else
+	fusion_filter_t fusion;
+#endif
+	float    angle;
+	float    travel;
+	settle_t settle;                      // settled reading detector on the angle
+	float    settledAngle;                // window mean when settled, angle otherwise
+	float    settledTravel;
+};
+
+/*--- MPU6050 addresses (AD0 low / high), the first one is mandatory, the others are used when present ---*/
+static const uint8_t sensorAddress[MEASURE_MAX_SENSORS] = {MPU6050_ADDRESS_AD0_LOW, MPU6050_ADDRESS_AD0_HIGH};
+static measure_sensor_t sensors[MEASURE_MAX_SENSORS];
+static uint8_t sensorCount = 0;
+static uint16_t loopPeriodMs = 10;
+static bool captureReference = false;  /* MEASURE_REQUEST_REFERENCE taken for this cycle */
+
+/*--- Low-power idle : after g_idleTimeoutS seconds of stillness, the MPU6050s go in accelero only   ---*/
+/*--- cycle mode with the motion interrupt, and the loop only checks the interrupt. Motion is seen   ---*/
+/*--- within IDLE_WAKE_MS + the loop period of the profile (INT status polled), or IDLE_WAKE_MS with  ---*/
+/*--- MPU_INT_GPIO wired : 35 ms worst case at 100 Hz, 25 ms with the INT pin.                        ---*/
+#define IDLE_WAKE_FREQUENCY     3       /* LP_WAKE_CTRL : 40 Hz on the MPU-6050 (1.25, 5, 20, 40 Hz)       */
+#define IDLE_WAKE_MS            25      /* cycle mode sample period                                        */
+#define IDLE_REQUEST_MS         200     /* with MPU_INT_GPIO, HTTP requests checked at this period         */
+#define IDLE_MOTION_THRESHOLD   10      /* MOT_THR, 2 mg per LSB : 20 mg, ~1 degree of surface rotation    */
+#define IDLE_MOTION_DURATION    1       /* MOT_DUR, samples above the threshold                            */
+
+/*--- Jitter analysis : gyro Y of the first MPU6050 through its FIFO at 1 kHz ---*/
+#define JITTER_FIFO_SIZE        1024    /* MPU6050 FIFO bytes                                              */
+#define JITTER_FIFO_READ_MAX    128     /* bytes read per cycle, 64 samples : 1.3 x a 50 ms loop at 1 kHz  */
+
+typedef enum {
+	MEASURE_ACTIVE,
+	MEASURE_IDLE
+} measure_state_t;
+
+static TaskHandle_t measureTask = NULL;
+static TaskHandle_t targetLedTask = NULL;       /* indicator task, notified by target_band_update()     */
+static volatile bool targetLedRefresh = false;
 
 /**
- * 	@fn			void meansensors(void)
- *	@brief		average sensors reading 
- * 	@param[in]	void
+ *	@fn 		static void update_i2c_stats(void)
+ *  @brief		Publish the I2C error counters of the MPU6050s for the server
+ *	@param[in]	void
  *	@return		void
  *
  */
-void meansensors(void){
-  long i=0,buff_ax=0,buff_ay=0,buff_az=0,buff_gx=0,buff_gy=0,buff_gz=0;
+static void update_i2c_stats(void)
+{
+	I2Cdev_stats_t stats;
+	uint32_t errors = 0, retries = 0, recoveries = 0;
 
-  while (i<(buffersize+101)){
-    // read raw accel/gyro measurements from device
-    mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
+	for(int i = 0; i < sensorCount; i++){
+		I2Cdev::getStats(sensors[i].address, &stats);
+		errors += stats.errors;
+		retries += stats.retries;
+		recoveries += stats.recoveries;
+	}
+	g_i2cErrors = errors;
+	g_i2cRetries = retries;
+	g_i2cRecoveries = recoveries;
 
-    if (i>100 && i<=(buffersize+100)){ //First 100 measures are discarded
-      buff_ax=buff_ax+ax;
-      buff_ay=buff_ay+ay;
-      buff_az=buff_az+az;
-      buff_gx=buff_gx+gx;
-      buff_gy=buff_gy+gy;
-      buff_gz=buff_gz+gz;
-    }
+} /* End update_i2c_stats() */
 
-    if (i==(buffersize+100)){
-      mean_ax=buff_ax/buffersize;
-      mean_ay=buff_ay/buffersize;
-      mean_az=buff_az/buffersize;
-      mean_gx=buff_gx/buffersize;
-      mean_gy=buff_gy/buffersize;
-      mean_gz=buff_gz/buffersize;
-    }
-    i++;
-    vTaskDelay(2/portTICK_PERIOD_MS); //Needed so we don't get repeated measures
-  }
-} /* End meansensors() */
+/**
+ *	@fn 		static void zupt_update(measure_sensor_t *s)
+ *  @brief		Stillness detection and online gyro bias estimation
+ *
+ *  @details	Accumulates the last raw sample in the current window. At the end of a window where
+ *				the surface stayed still, the gyro mean of the window is the gyro bias: the estimate
+ *				is moved toward it. Runs at each sample, measurement is never stopped.
+ *	@param[in]	s : MPU6050 of the sample
+ *	@return		void
+ *
+ */
+static void zupt_update(measure_sensor_t *s)
+{
+	zupt_window_t &zupt = s->zupt;
+	const int32_t accel[3] = {s->ax * s->accelScale, s->ay * s->accelScale, s->az * s->accelScale};
+	const int32_t gyro[3] = {s->gx * s->gyroScale, s->gy * s->gyroScale, s->gz * s->gyroScale};
+
+	for(int i = 0; i < 3; i++){
+		zupt.accelSum[i] += accel[i];
+		zupt.accelSumSq[i] += (int64_t)accel[i] * accel[i];
+		zupt.gyroSum[i] += gyro[i];
+		if(fabsf(gyro[i] - s->modelBias[i] - s->gyroBias[i]) > ZUPT_GYRO_MAX)
+			zupt.moving = true;
+	}
+
+	if(++zupt.count < ZUPT_WINDOW)
+		return;
+
+	/*--- End of window : N*sum(x^2) - sum(x)^2 = N^2 * variance ---*/
+	bool still = !zupt.moving;
+	for(int i = 0; i < 3 && still; i++){
+		int64_t varN2 = (int64_t)ZUPT_WINDOW * zupt.accelSumSq[i] - (int64_t)zupt.accelSum[i] * zupt.accelSum[i];
+		if(varN2 > (int64_t)ZUPT_WINDOW * ZUPT_WINDOW * ZUPT_ACCEL_STD_MAX * ZUPT_ACCEL_STD_MAX)
+			still = false;
+	}
+
+	if(still){
+		float mean[3];
+		for(int i = 0; i < 3; i++){
+			mean[i] = (float)zupt.gyroSum[i] / ZUPT_WINDOW;
+			s->gyroBias[i] += ZUPT_BIAS_GAIN * (mean[i] - s->modelBias[i] - s->gyroBias[i]);
+		}
+		gyro_tbias_learn(&s->tbias, s->temperature, mean);
+	}
+	s->still = still;
+
+	memset(&zupt, 0, sizeof(zupt));
+
+} /* End zupt_update() */
 
 /**
- *	@fn 		void calibration(void)
- *	@brief		MPU6050 calibration
- * 	@param[in]	void
+ *	@fn 		static void tbias_update(measure_sensor_t *s)
+ *  @brief		Temperature model of the gyro bias, low rate part
+ *
+ *  @details	The prediction of the model only changes with the die temperature : it is computed
+ *				once a second and the measure loop just removes the cached value.
+ *	@param[in]	s : MPU6050 of the sample
  *	@return		void
  *
  */
-void calibration(void){
-  ax_offset=-mean_ax/8;
-  ay_offset=-mean_ay/8;
-  az_offset=(16384-mean_az)/8;
+static void tbias_update(measure_sensor_t *s)
+{
+	s->temperature = s->temp / 340.0f + 36.53f;	/* see MPU6050 register map p30 */
 
-  gx_offset=-mean_gx/4;
-  gy_offset=-mean_gy/4;
-  gz_offset=-mean_gz/4;
-  
-  while (1){
-    int ready=0;
-    mpu.setXAccelOffset(ax_offset);
-    mpu.setYAccelOffset(ay_offset);
-    mpu.setZAccelOffset(az_offset);
+	gyro_tbias_get(&s->tbias, s->temperature, s->modelBias);
+	gyro_tbias_save(&s->tbias);
 
-    mpu.setXGyroOffset(gx_offset);
-    mpu.setYGyroOffset(gy_offset);
-    mpu.setZGyroOffset(gz_offset);
+} /* End tbias_update() */
 
-    meansensors();
+#if ESP_MAD_ATTITUDE_3D
+/*--- Hinge axis of each MPU6050 in NVS, learnt once for a mounting ---*/
+#define HINGE_NVS_NAMESPACE     "esp_mad"
+#define HINGE_NVS_KEY           "hinge"         /* first MPU6050, "hinge_69" for 0x69 ...                          */
+#define HINGE_VERSION           1
 
-    if (abs(mean_ax)<=acel_deadzone) ready++;
-    else ax_offset=ax_offset-mean_ax/acel_deadzone;
+typedef struct {
+	uint32_t version;
+	float    axis[3];                       /* unit hinge axis in the sensor frame                     */
+} hinge_nvs_t;
 
-    if (abs(mean_ay)<=acel_deadzone) ready++;
-    else ay_offset=ay_offset-mean_ay/acel_deadzone;
+/**
+ *	@fn 		static void hinge_key(char *key, size_t size, uint8_t devAddr)
+ *  @brief		NVS key of the hinge axis of a MPU6050
+ *	@param[out]	key / size : key
+ *	@param[in]	devAddr : I2C address of the MPU6050
+ *	@return		void
+ *
+ */
+static void hinge_key(char *key, size_t size, uint8_t devAddr)
+{
+	if(devAddr == sensorAddress[0])
+		snprintf(key, size, HINGE_NVS_KEY);
+	else
+		snprintf(key, size, HINGE_NVS_KEY "_%02x", devAddr);
+
+} /* End hinge_key() */
+
+/**
+ *	@fn 		static void hinge_load(measure_sensor_t *s)
+ *  @brief		Hinge axis learnt in a previous session, the attitude learns it otherwise
+ *	@param[in]	s : MPU6050
+ *	@return		void
+ *
+ */
+static void hinge_load(measure_sensor_t *s)
+{
+	nvs_handle_t handle;
+	hinge_nvs_t hinge;
+	size_t size = sizeof(hinge);
+	char key[16];
+
+	hinge_key(key, sizeof(key), s->address);
+	esp_err_t err = nvs_open(HINGE_NVS_NAMESPACE, NVS_READONLY, &handle);
+	if(err == ESP_OK){
+		err = nvs_get_blob(handle, key, &hinge, &size);
+		nvs_close(handle);
+	}
+
+	if(err == ESP_OK && size == sizeof(hinge) && hinge.version == HINGE_VERSION){
+		s->attitude.setHinge(VectorFloat(hinge.axis[0], hinge.axis[1], hinge.axis[2]));
+		ESP_LOGI(TAG, "%s restored : %.2f %.2f %.2f", key, hinge.axis[0], hinge.axis[1], hinge.axis[2]);
+	}
+	else if(err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND)
+		ESP_LOGI(TAG, "no %s in NVS, learnt from the first throw", key);
+	else
+		ESP_LOGE(TAG, "%s not read (%s), learnt from the first throw", key, esp_err_to_name(err));
+
+} /* End hinge_load() */
+
+/**
+ *	@fn 		static void hinge_store(measure_sensor_t *s, bool erase)
+ *  @brief		Save the hinge axis just learnt, or erase it (sensor moved to another surface)
+ *	@param[in]	s : MPU6050, erase : erase instead of save
+ *	@return		void
+ *
+ */
+static void hinge_store(measure_sensor_t *s, bool erase)
+{
+	nvs_handle_t handle;
+	VectorFloat axis = s->attitude.hingeAxis();
+	hinge_nvs_t hinge = {HINGE_VERSION, {axis.x, axis.y, axis.z}};
+	char key[16];
+	esp_err_t err;
+
+	hinge_key(key, sizeof(key), s->address);
+	if((err = nvs_open(HINGE_NVS_NAMESPACE, NVS_READWRITE, &handle)) != ESP_OK){
+		ESP_LOGW(TAG, "nvs_open failed (%s)", esp_err_to_name(err));
+		return;
+	}
+
+	err = erase ? nvs_erase_key(handle, key) : nvs_set_blob(handle, key, &hinge, sizeof(hinge));
+	if(err == ESP_ERR_NVS_NOT_FOUND)
+		err = ESP_OK;
+	if(err == ESP_OK)
+		err = nvs_commit(handle);
+	nvs_close(handle);
 
-    if (abs(16384-mean_az)<=acel_deadzone) ready++;
-    else az_offset=az_offset+(16384-mean_az)/acel_deadzone;
+	if(err != ESP_OK)
+		ESP_LOGW(TAG, "%s not %s (%s)", key, erase ? "erased" : "saved", esp_err_to_name(err));
+
+} /* End hinge_store() */
+
+/**
+ *	@fn 		static void attitude_update(measure_sensor_t *s, const attitude_sample_t &sample)
+ *  @brief		Attitude and hinge angle of a sample, timed : mean and max over ATTITUDE_STATS_SAMPLES
+ *				updates are published in g_attitudeUs / g_attitudeMaxUs (/runtime_stats)
+ *	@param[in]	s : MPU6050, sample : bias-free sample
+ *	@return		void
+ *
+ */
+static void attitude_update(measure_sensor_t *s, const attitude_sample_t &sample)
+{
+	static uint32_t sumUs = 0, maxUs = 0, count = 0;
+	int64_t start = esp_timer_get_time();
 
-    if (abs(mean_gx)<=giro_deadzone) ready++;
-    else gx_offset=gx_offset-mean_gx/(giro_deadzone+1);
+	s->attitude.update(sample);
+	if(captureReference)
+		s->attitude.captureReference();
+	s->angle = s->attitude.hingeAngle();
 
-    if (abs(mean_gy)<=giro_deadzone) ready++;
-    else gy_offset=gy_offset-mean_gy/(giro_deadzone+1);
+	uint32_t us = (uint32_t)(esp_timer_get_time() - start);
+	sumUs += us;
+	if(us > maxUs)
+		maxUs = us;
+	if(++count == ATTITUDE_STATS_SAMPLES){
+		g_attitudeUs = sumUs / count;
+		g_attitudeMaxUs = maxUs;
+		sumUs = maxUs = count = 0;
+	}
 
-    if (abs(mean_gz)<=giro_deadzone) ready++;
-    else gz_offset=gz_offset-mean_gz/(giro_deadzone+1);
+	/*--- Hinge axis learnt on this throw : kept for the next sessions ---*/
+	if(s->attitude.hingeToSave())
+		hinge_store(s, false);
+	if(s == &sensors[0])
+		g_hingeLearnt = s->attitude.hingeLearnt();
 
-    if (ready==6) break;
-  }
-} /* End calibration */
+} /* End attitude_update() */
+#endif
 
 /**
- *	@fn 		void InitMPU6050(void)
- *  @brief		MPU6050 Initialisation	
+ *	@fn 		static void sensor_update(measure_sensor_t *s)
+ *  @brief		Angle and travel of a surface from its last sample
+ *	@param[in]	s : MPU6050 of the sample
+ *	@return		void
+ *
+ */
+static void sensor_update(measure_sensor_t *s)
+{
+	/*--- Six-position correction of the accelero : scale, bias and cross-axis, in integer ---*/
+	accel_cal_apply(&s->accelCal, &s->ax, &s->ay, &s->az, s->accelScale);
+
+	/*--- ESP_MAD_ATTITUDE_3D : the 3-D attitude is updated with the 3 axes (see esp_mad_attitude.cpp)   ---*/
+	/*--- and the angle is the rotation about the hinge axis since the reference orientation.            ---*/
+	/*--- Otherwise :                                                                                     ---*/
+	/*--- Compute Y angle in degree. A fusion filter is used to combine accelero and gyro datas          ---*/
+	/*--- see  http://www.pieter-jan.com/node/11 for more information regarding the complementary filter  ---*/
+	/*--- or https://delta-iot.com/la-theorie-du-filtre-complementaire/ (in french)                       ---*/
+	/*--- Gyro are used for fast motion as accelero are used for slow motion. The filter (complementary,  ---*/
+	/*--- Mahony or Kalman) is selected with ESP_MAD_FUSION_FILTER, see esp_mad_fusion.h.                 ---*/
+	/*--- dt comes from the sample timestamps.                                                            ---*/
+	/*--- Raw GyrData need to be divide by the sensitivity scale factor (131). see MPU6050 datasheet p12. ---*/
+	/*--- A positive gy tilts X down, it decreases atan2(ax, az) : the rate is -gy.                       ---*/
+	/*--- The gyro bias predicted by the temperature model (see tbias_update()) and re-estimated while    ---*/
+	/*--- the surface is still (see zupt_update()) is removed from the gyro. Biases are kept in 250 deg/s ---*/
+	/*--- range LSB, whatever the range of the acquisition profile.                                      ---*/
+	if(++s->sampleCount % TBIAS_PERIOD == 0)
+		tbias_update(s);
+	zupt_update(s);
+
+	/*--- Accelero spikes removed by a median, accelero rejected when |a| is not ~1 g (see esp_mad_prefilter.cpp). ---*/
+	/*--- The stillness detection above works on the corrected samples.                                           ---*/
+	int16_t ax = s->ax, ay = s->ay, az = s->az;
+	bool accelValid = accel_prefilter(&s->prefilter, &ax, &ay, &az, s->accelScale);
+#if ESP_MAD_ATTITUDE_3D
+	attitude_sample_t sample = {s->timestamp, ax, ay, az,
+								(float(s->gx * s->gyroScale) - s->modelBias[0] - s->gyroBias[0]) / 131.0f,
+								(float(s->gy * s->gyroScale) - s->modelBias[1] - s->gyroBias[1]) / 131.0f,
+								(float(s->gz * s->gyroScale) - s->modelBias[2] - s->gyroBias[2]) / 131.0f,
+								accelValid};
+	attitude_update(s, sample);
+#else
+	fusion_sample_t sample = {s->timestamp, ax, ay, az, -(float(s->gy * s->gyroScale) - s->modelBias[1] - s->gyroBias[1]) / 131.0f, accelValid};
+	s->angle = s->fusion.update(sample);
+#endif
+
+	/*--- Compute Control surface travel using : 2* sin(angle/2)* chord. Angle for sinus function needs  ---*/
+	/*--- to be converted in radian (angleDegre = angleRadian *(2*PI)/360)                               ---*/
+	s->travel = g_chordControlSurface * sin((s->angle*(2.0*PI)/360.0)/2.0) * 2.0;
+
+	/*--- Settled reading : the window mean replaces the flickering angle once the surface is steady. ---*/
+	/*--- A new reference orientation moves the angle, the window starts again.                     ---*/
+	if(captureReference)
+		settle_reset(&s->settle);
+	if(settle_update(&s->settle, s->angle)){
+		s->settledAngle = s->settle.mean;
+		s->settledTravel = g_chordControlSurface * sin((s->settledAngle*(2.0*PI)/360.0)/2.0) * 2.0;
+	}
+	else{
+		s->settledAngle = s->angle;
+		s->settledTravel = s->travel;
+	}
+
+} /* End sensor_update() */
+
+/**
+ *	@fn 		static void profile_apply(int index)
+ *  @brief		Configure the MPU6050s and the loop with an acquisition profile
+ *	@param[in]	index : profile index (see esp_mad_profile.cpp)
+ *	@return		void
+ *
+ */
+static void profile_apply(int index)
+{
+	const acquisition_profile_t *profile = acquisition_profile_get(index);
+
+	for(int i = 0; i < sensorCount; i++){
+		measure_sensor_t *s = &sensors[i];
+
+		/*--- Rate, DLPF and ranges in one burst (consecutive registers) ---*/
+		if(!s->mpu.setAcquisitionConfig(profile->rateDiv, profile->dlpfMode, profile->gyroRange, profile->accelRange))
+			ESP_LOGE(TAG, "MPU6050 0x%02x : profile %s not applied", s->address, profile->name);
+
+		s->gyroScale = 1 << profile->gyroRange;
+		s->accelScale = 1 << profile->accelRange;
+		memset(&s->zupt, 0, sizeof(s->zupt));
+	}
+
+	loopPeriodMs = profile->loopPeriodMs;
+	g_acquisitionProfile = index;
+	ESP_LOGI(TAG, "profile %s : %d Hz, loop %d ms", profile->name, 1000 / (1 + profile->rateDiv), loopPeriodMs);
+
+} /* End profile_apply() */
+
+#ifdef MPU_INT_GPIO
+/**
+ *	@fn 		static void IRAM_ATTR mpu_int_isr(void *arg)
+ *  @brief		MPU6050 INT pin, wakes the measure task up from idle
+ *
+ */
+static void IRAM_ATTR mpu_int_isr(void *arg)
+{
+	BaseType_t woken = pdFALSE;
+
+	vTaskNotifyGiveFromISR(measureTask, &woken);
+	portYIELD_FROM_ISR(woken);
+
+} /* End mpu_int_isr() */
+#endif
+
+/**
+ *	@fn 		static void jitter_configure(bool enable)
+ *  @brief		First MPU6050 at 1 kHz with its gyro Y in the FIFO, or back to the acquisition profile
+ *	@param[in]	enable : analysis running
+ *	@return		void
+ *
+ */
+static void jitter_configure(bool enable)
+{
+	MPU6050 &mpu = sensors[0].mpu;
+
+	mpu.setFIFOEnabled(false);
+	mpu.setYGyroFIFOEnabled(enable);
+	mpu.resetFIFO();
+
+	if(enable){
+		/*--- DLPF 188 Hz keeps the 1 kHz rate (rateDiv 0) and the flutter band ---*/
+		mpu.setDLPFMode(MPU6050_DLPF_BW_188);
+		mpu.setRate(0);
+		jitter_reset();
+		mpu.setFIFOEnabled(true);
+	}
+	else
+		profile_apply(g_acquisitionProfile);
+
+} /* End jitter_configure() */
+
+/**
+ *	@fn 		static void jitter_read(measure_sensor_t *s)
+ *  @brief		Drain the FIFO of the first MPU6050 into the jitter analysis
+ *	@param[in]	s : first MPU6050
+ *	@return		void
+ *
+ */
+static void jitter_read(measure_sensor_t *s)
+{
+	uint8_t bytes[JITTER_FIFO_READ_MAX];
+	int16_t gy[JITTER_FIFO_READ_MAX / 2];
+	uint16_t count;
+
+	/*--- Count not read : nothing taken from the FIFO, read again at the next cycle ---*/
+	if(!s->mpu.getFIFOCount(&count))
+		return;
+
+	if(count >= JITTER_FIFO_SIZE){
+		s->mpu.resetFIFO();
+		jitter_fifo_overflow();
+		return;
+	}
+
+	count &= ~1;
+	if(count > JITTER_FIFO_READ_MAX)
+		count = JITTER_FIFO_READ_MAX;
+	if(count == 0)
+		return;
+
+	/*--- Bytes lost and the samples maybe out of step : block dropped, FIFO restarted ---*/
+	if(!s->mpu.getFIFOBytes(bytes, count)){
+		s->mpu.resetFIFO();
+		jitter_read_error();
+		return;
+	}
+	for(int i = 0; i < count / 2; i++)
+		gy[i] = (int16_t)((bytes[2 * i] << 8) | bytes[2 * i + 1]);
+	jitter_push(gy, count / 2, s->gyroScale / 131.0f);
+
+} /* End jitter_read() */
+
+/**
+ *	@fn 		static void idle_enter(void)
+ *  @brief		MPU6050s in accelero only cycle mode with the motion interrupt
  *	@param[in]	void
- *	@return		void	
- * 
+ *	@return		void
+ *
+ */
+static void idle_enter(void)
+{
+
+	for(int i = 0; i < sensorCount; i++){
+		MPU6050 &mpu = sensors[i].mpu;
+
+		mpu.setDHPFMode(MPU6050_DHPF_5);	/* motion detection works on the high-pass filtered accelero */
+		mpu.setMotionDetectionThreshold(IDLE_MOTION_THRESHOLD);
+		mpu.setMotionDetectionDuration(IDLE_MOTION_DURATION);
+		mpu.setInterruptLatch(true);
+		mpu.setInterruptLatchClear(true);
+		mpu.getIntStatus();					/* clear a pending interrupt */
+		mpu.setIntMotionEnabled(true);
+		mpu.setLowPowerAccelMode(true, IDLE_WAKE_FREQUENCY);
+	}
+
+	g_idle = true;
+	ESP_LOGI(TAG, "idle, waiting for motion");
+
+} /* End idle_enter() */
+
+/**
+ *	@fn 		static bool idle_motion(void)
+ *  @brief		Motion seen by a MPU6050, or a request that needs the measure
+ *	@param[in]	void
+ *	@return		true to leave the idle state
+ *
+ */
+static bool idle_motion(void)
+{
+	bool motion = g_profileRequest >= 0 || __atomic_load_n(&g_measureRequests, __ATOMIC_ACQUIRE) != 0 || sweep_busy() || jitter_requested();
+
+	for(int i = 0; i < sensorCount; i++)
+		motion |= sensors[i].mpu.getIntMotionStatus();	/* reading INT_STATUS clears the latch */
+	return motion;
+
+} /* End idle_motion() */
+
+/**
+ *	@fn 		static void idle_exit(void)
+ *  @brief		Back to the acquisition profile
+ *	@param[in]	void
+ *	@return		void
+ *
  */
-void InitMPU6050(void)
-{
-	static const char tagI[] = "Init ->";
-
-	/*--- Display message ---*/
-  	ESP_LOGI(tagI, "Calibration Start...\n");
-
-    /*--- reset offsets   ---*/
-  	mpu.setXAccelOffset(0);
-  	mpu.setYAccelOffset(0);
-  	mpu.setZAccelOffset(0);
-  	mpu.setXGyroOffset(0);
-    mpu.setYGyroOffset(0);
-	mpu.setZGyroOffset(0);
-
-  	/*--- Step 1 : first reading ---*/
-  	ESP_LOGI(tagI,"First reading...\n");
-	meansensors();
-  	vTaskDelay(100/portTICK_PERIOD_MS);
-
-  	/*--- Step 2 : Compute offsets ---*/
-  	ESP_LOGI(tagI,"Compute offsets...\n");
-	calibration();
-  	vTaskDelay(100/portTICK_PERIOD_MS);
-
-  	/*--- New reads and offsets display ---*/
-  	meansensors();
-	ESP_LOGI(tagI, "FINISHED!\n");
-	ESP_LOGI(tagI, "offset: ax: %d - ay: %d - az: %d - gx: %d - gy: %d - gz: %d\n",
-			ax_offset, ay_offset, az_offset,gx_offset,gy_offset,gz_offset);
-	ESP_LOGI(tagI, "Read w. off : ax : %d - ay :%d - az :%d - gx : %d - gy :%d - gz :%d\n",
-			mean_ax,mean_ay,mean_az,mean_gx,mean_gy,mean_gz);
-  
-	/*--- Set the end of calibration ---*/
-	BInit = 1;
-
-  	/*--- Set offsets with the compute values ---*/
-  	mpu.setXAccelOffset(ax_offset);
-  	mpu.setYAccelOffset(ay_offset);
-  	mpu.setZAccelOffset(az_offset);
-  	mpu.setXGyroOffset(gx_offset);
-  	mpu.setYGyroOffset(gy_offset);
-  	mpu.setZGyroOffset(gz_offset);
-  
-} /* End Init() */
+static void idle_exit(void)
+{
+
+	for(int i = 0; i < sensorCount; i++){
+		MPU6050 &mpu = sensors[i].mpu;
+
+		mpu.setIntMotionEnabled(false);
+		mpu.setLowPowerAccelMode(false, IDLE_WAKE_FREQUENCY);
+		mpu.setDHPFMode(MPU6050_DHPF_RESET);
+	}
+	profile_apply(g_acquisitionProfile);
+
+	g_idle = false;
+	ESP_LOGI(TAG, "motion, back to %s", acquisition_profile_get(g_acquisitionProfile)->name);
+
+} /* End idle_exit() */
+
+/**
+ *	@fn 		static void accel_calib_offsets(measure_sensor_t *s, bool leveled)
+ *  @brief		Accelero offset registers : boot leveling, or 0 for a six-position correction
+ *	@param[in]	s : MPU6050
+ *	@param[in]	leveled : offsets computed by the offset calibration
+ *	@return		void
+ *
+ */
+static void accel_calib_offsets(measure_sensor_t *s, bool leveled)
+{
+	s->mpu.setXAccelOffset(leveled ? s->ax_offset : 0);
+	s->mpu.setYAccelOffset(leveled ? s->ay_offset : 0);
+	s->mpu.setZAccelOffset(leveled ? s->az_offset : 0);
+	memset(&s->prefilter, 0, sizeof(s->prefilter));
+
+} /* End accel_calib_offsets() */
+
+/**
+ *	@fn 		static void accel_calib_finish(measure_sensor_t *s, const accel_cal_t *cal, bool clear)
+ *  @brief		End of a six-position session : new correction, previous one back, or none
+ *	@param[in]	s : MPU6050 of the session
+ *	@param[in]	cal : fitted correction, not valid if the session is cancelled or rejected
+ *	@param[in]	clear : the stored correction is erased
+ *	@return		void
+ *
+ */
+static void accel_calib_finish(measure_sensor_t *s, const accel_cal_t *cal, bool clear)
+{
+	if(clear){
+		accel_cal_erase(s->address);
+		s->accelCal.valid = false;
+	}
+	else if(cal->valid){
+		accel_cal_save(cal, s->address);
+		s->accelCal = *cal;
+	}
+	else
+		accel_cal_load(&s->accelCal, s->address);
+
+	accel_calib_offsets(s, !s->accelCal.valid);
+
+} /* End accel_calib_finish() */
+
+/**
+ *	@fn 		void measure_target_led(TaskHandle_t task)
+ *  @brief		Task notified with the target band and bar (target_notify_value(), eSetValueWithOverwrite)
+ *				when they or the calibration state change
+ *	@param[in]	task : indicator task (see esp_mad_indicator.cpp)
+ *	@return		void
+ *
+ */
+void measure_target_led(TaskHandle_t task)
+{
+	targetLedTask = task;
+	targetLedRefresh = true;
+
+} /* End measure_target_led() */
+
+/**
+ *	@fn 		static void target_band_update(void)
+ *  @brief		Target band and bar of the first surface, the indicator task is only notified on a
+ *				change of the band, of the bar or of the calibration state (status led pattern)
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+static void target_band_update(void)
+{
+	uint8_t band = TARGET_BAND_OFF;
+	int8_t bar = 0;
+
+	if(g_targetAngleActive && g_calibrationState != CALIBRATION_BOOT){
+		float deviation = g_angleSettled - g_angleZeroOffset - g_targetAngle;
+		band = target_band(deviation);
+		bar = target_bar(deviation, TARGET_LED_COUNT);
+	}
+
+	/*--- With a bar graph, every move of the bar end is sent, i.e. up to one frame per sample ---*/
+	static uint8_t calibration = CALIBRATION_BOOT;
+	static int8_t lastBar = 0;
+	if(band == g_targetBand && bar == lastBar && g_calibrationState == calibration && !targetLedRefresh)
+		return;
+	g_targetBand = band;
+	lastBar = bar;
+	calibration = g_calibrationState;
+	targetLedRefresh = false;
+	if(targetLedTask != NULL)
+		xTaskNotify(targetLedTask, target_notify_value(band, bar), eSetValueWithOverwrite);
+
+} /* End target_band_update() */
+
+/**
+ *	@fn 		static void calib_start(void)
+ *  @brief		Start the offset calibration of every MPU6050
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+static void calib_start(void)
+{
+	for(int i = 0; i < sensorCount; i++)
+		memset(&sensors[i].calib, 0, sizeof(calib_window_t));
+	g_calibrationProgress = 0;
+
+} /* End calib_start() */
+
+/**
+ *	@fn 		static void calib_sample(measure_sensor_t *s)
+ *  @brief		Raw sample in the calibration window of a MPU6050
+ *
+ *  @details	At the end of a still window, the new offsets are computed from the means and
+ *				kept until every MPU6050 is done.
+ *	@param[in]	s : MPU6050 of the sample, without accelero correction
+ *	@return		void
+ *
+ */
+static void calib_sample(measure_sensor_t *s)
+{
+	calib_window_t &calib = s->calib;
+
+	if(calib.done || ++calib.count <= CALIB_DISCARD)
+		return;
+
+	const int32_t raw[6] = {s->ax * s->accelScale, s->ay * s->accelScale, s->az * s->accelScale,
+							s->gx * s->gyroScale, s->gy * s->gyroScale, s->gz * s->gyroScale};
+	for(int i = 0; i < 6; i++){
+		calib.sum[i] += raw[i];
+		calib.sumSq[i] += (int64_t)raw[i] * raw[i];
+	}
+
+	int n = calib.count - CALIB_DISCARD;
+	if(n < CALIB_SAMPLES)
+		return;
+
+	/*--- End of window : N*sum(x^2) - sum(x)^2 = N^2 * variance, the surface must be still ---*/
+	for(int i = 0; i < 6; i++){
+		int64_t limit = i < 3 ? ZUPT_ACCEL_STD_MAX : ZUPT_GYRO_MAX;
+		int64_t varN2 = (int64_t)n * calib.sumSq[i] - (int64_t)calib.sum[i] * calib.sum[i];
+		if(varN2 > (int64_t)n * n * limit * limit){
+			memset(&calib, 0, sizeof(calib));
+			g_calibrationRestarts++;
+			return;
+		}
+	}
+
+	/*--- New offsets from the means. With a six-position correction the accelero is not leveled ---*/
+	const int current[6] = {s->ax_offset, s->ay_offset, s->az_offset, s->gx_offset, s->gy_offset, s->gz_offset};
+	const float target[3] = {0.0f, 0.0f, 16384.0f};
+	for(int i = 0; i < 3; i++){
+		float mean = (float)calib.sum[i] / n;
+		calib.offset[i] = s->accelCal.valid ? current[i] : current[i] + (int)lroundf((target[i] - mean) / CALIB_ACCEL_STEP);
+	}
+	for(int i = 3; i < 6; i++){
+		float mean = (float)calib.sum[i] / n;
+		calib.offset[i] = current[i] - (int)lroundf(mean / CALIB_GYRO_STEP);
+	}
+	calib.done = true;
+
+} /* End calib_sample() */
+
+/**
+ *	@fn 		static bool calib_done(void)
+ *  @brief		Every calibration window is done, publishes the progress of the slowest one
+ *	@param[in]	void
+ *	@return		true when the offsets can be swapped in
+ *
+ */
+static bool calib_done(void)
+{
+	int progress = 100;
+
+	for(int i = 0; i < sensorCount; i++){
+		const calib_window_t &calib = sensors[i].calib;
+		if(!calib.done){
+			int n = calib.count > CALIB_DISCARD ? calib.count - CALIB_DISCARD : 0;
+			if(n * 100 / CALIB_SAMPLES < progress)
+				progress = n * 100 / CALIB_SAMPLES;
+		}
+	}
+	g_calibrationProgress = progress;
+	return progress == 100;
+
+} /* End calib_done() */
+
+/**
+ *	@fn 		static void calib_swap(void)
+ *  @brief		Write the new offsets of every MPU6050 at once, between two samples
+ *
+ *  @details	The models working on the readings start again with the new offsets : temperature
+ *				model offsets, residual gyro bias, prefilter, fusion and settle window. The reference
+ *				orientation is captured again by the first sample, as after power-on.
+ *	@param[in]	void
+ *	@return		void
+ *
+ */
+static void calib_swap(void)
+{
+
+	for(int i = 0; i < sensorCount; i++){
+		measure_sensor_t *s = &sensors[i];
+		const int *offset = s->calib.offset;
+
+		s->ax_offset = offset[0];
+		s->ay_offset = offset[1];
+		s->az_offset = offset[2];
+		s->gx_offset = offset[3];
+		s->gy_offset = offset[4];
+		s->gz_offset = offset[5];
+		accel_calib_offsets(s, !s->accelCal.valid);
+		s->mpu.setXGyroOffset(s->gx_offset);
+		s->mpu.setYGyroOffset(s->gy_offset);
+		s->mpu.setZGyroOffset(s->gz_offset);
+
+		gyro_tbias_offset(&s->tbias, &offset[3]);
+		memset(s->gyroBias, 0, sizeof(s->gyroBias));
+		tbias_update(s);
+		memset(&s->zupt, 0, sizeof(s->zupt));
+#if ESP_MAD_ATTITUDE_3D
+		s->attitude.restart();
+#else
+		s->fusion = fusion_filter_t();
+#endif
+		settle_reset(&s->settle);
+
+		ESP_LOGI(TAG, "MPU6050 0x%02x offsets : ax %d - ay %d - az %d - gx %d - gy %d - gz %d", s->address,
+				 s->ax_offset, s->ay_offset, s->az_offset, s->gx_offset, s->gy_offset, s->gz_offset);
+	}
+	g_calibrationProgress = 100;
+
+} /* End calib_swap() */
 
 /**
  *	@fn 		void task_measure(void*)
@@ -195,55 +862,252 @@ void InitMPU6050(void)
  */
 void task_measure(void*){
 
-	static const char tagd[] = "task_measure->";
-
-	/*--- I2C Configuration and initialization ---*/
-	i2c_config_t conf;
-	conf.mode = I2C_MODE_MASTER;
-	conf.sda_io_num = (gpio_num_t)PIN_SDA;
-	conf.scl_io_num = (gpio_num_t)PIN_CLK;
-	conf.sda_pullup_en = GPIO_PULLUP_ENABLE;
-	conf.scl_pullup_en = GPIO_PULLUP_ENABLE;
-	conf.master.clk_speed = 400000;
-	ESP_ERROR_CHECK(i2c_param_config(I2C_NUM_0, &conf));
-	ESP_ERROR_CHECK(i2c_driver_install(I2C_NUM_0, I2C_MODE_MASTER, 0, 0, 0));
-
-	/*--- MPU6050 Initialization ---*/
-	ESP_LOGI(tagd,"MPU6050 initialization ...");
-	mpu.initialize();
-
-	/*--- I2C Connection Test ---*/
-	if(mpu.testConnection())
-		ESP_LOGI(tagd, "I2C connection OK\n");
-	
-	else
-	 	ESP_LOGE(tagd, "I2C connection Error\n");
 
-	/*--- MPU6050 Calibration ---*/
-	InitMPU6050();
+	/*--- I2C Configuration and initialization. I2Cdev keeps the configuration for the bus recovery ---*/
+	ESP_ERROR_CHECK(I2Cdev::initialize(I2C_NUM_0, (gpio_num_t)PIN_SDA, (gpio_num_t)PIN_CLK, 400000));
+
+	/*--- MPU6050 detection. The first one is always used (as before, an error is only logged), the ---*/
+	/*--- next ones are used when they answer on the bus.                                            ---*/
+	for(int i = 0; i < MEASURE_MAX_SENSORS; i++){
+		if(i > 0 && !I2Cdev::probe(sensorAddress[i]))
+			continue;
+
+		measure_sensor_t *s = &sensors[sensorCount++];
+		s->address = sensorAddress[i];
+		s->mpu = MPU6050(s->address);
+
+		/*--- MPU6050 Initialization. Register shadow avoids the read part of the read-modify-write ---*/
+		ESP_LOGI(TAG, "MPU6050 0x%02x initialization ...", s->address);
+		s->mpu.setRegisterShadowEnabled(true);
+		s->mpu.initialize();
+
+		/*--- I2C Connection Test ---*/
+		if(s->mpu.testConnection())
+			ESP_LOGI(TAG, "I2C connection OK\n");
+		else
+		 	ESP_LOGE(TAG, "I2C connection Error\n");
+	}
+	g_sensorCount = sensorCount;
+
+	/*--- Offsets reset, then temperature model of the gyro bias, learnt along the sessions. The ---*/
+	/*--- calibration itself runs in the loop (CALIBRATION_BOOT), nothing is measured meanwhile. ---*/
+	for(int i = 0; i < sensorCount; i++){
+		measure_sensor_t *s = &sensors[i];
+		const int gyroOffset[3] = {0, 0, 0};
+
+		accel_cal_load(&s->accelCal, s->address);
+		accel_calib_offsets(s, true);
+		s->mpu.setXGyroOffset(0);
+		s->mpu.setYGyroOffset(0);
+		s->mpu.setZGyroOffset(0);
+		gyro_tbias_init(&s->tbias, s->address, gyroOffset);
+		s->temp = s->mpu.getTemperature();
+		tbias_update(s);
+#if ESP_MAD_ATTITUDE_3D
+		hinge_load(s);
+#endif
+	}
+
+	/*--- Acquisition profile saved by the user ---*/
+	profile_apply(acquisition_profile_load());
+	calib_start();
+	g_calibrationState = CALIBRATION_BOOT;
+
+	TickType_t lastWake = xTaskGetTickCount();
+	TickType_t stillSince = lastWake;
+	measure_state_t state = MEASURE_ACTIVE;
+	bool jitterRunning = false;
+
+	jitter_init();
+
+	/*--- With power management, the CPU runs at full clock only during the acquisition and the ---*/
+	/*--- computation of a sample; it may scale down or light sleep until the next one.         ---*/
+#if CONFIG_PM_ENABLE
+	esp_pm_lock_handle_t pmLock = NULL;
+	if(esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "measure", &pmLock) != ESP_OK)
+		ESP_LOGW(TAG, "measure PM lock not created");
+#endif
+
+	/*--- Optional wiring of the MPU6050 INT pin (active high), otherwise its status is polled ---*/
+	measureTask = xTaskGetCurrentTaskHandle();
+#ifdef MPU_INT_GPIO
+	gpio_config_t intConfig = {};
+	intConfig.pin_bit_mask = 1ULL << MPU_INT_GPIO;
+	intConfig.mode = GPIO_MODE_INPUT;
+	intConfig.intr_type = GPIO_INTR_POSEDGE;
+	gpio_config(&intConfig);
+	gpio_install_isr_service(0);
+	gpio_isr_handler_add((gpio_num_t)MPU_INT_GPIO, mpu_int_isr, NULL);
+#endif
 
 	/*--- Infinite loop ---*/
 	while(1){
 
-		/*--- Compute Y angle in degree. Complementary filter is used to combine accelero and gyro datas      ---*/
-    	/*--- see  http://www.pieter-jan.com/node/11 for more information regarding the complementary filter  ---*/
-    	/*--- or https://delta-iot.com/la-theorie-du-filtre-complementaire/ (in french)                       ---*/
-    	/*--- Basically complementary filter avoid used of kallman filter, quiet difficult to implement in    ---*/
-    	/*--- small platform. Gyro are used for fast motion as accelero are used for slow motion.             ---*/
-		/*--- The formula to compute angle is angle = 0.98 * (angle + gyrData * dt) + (0.02 * accData)        ---*/
-		/*--- dt is 10 ms (so 0.01).                                                                          ---*/
-		/*--- Raw GyrData need to be divide by the sensitivity scale factor (131). see MPU6050 datasheet p12. ---*/                     
-    	mpu.getMotion6(&ax, &ay, &az, &gx, &gy, &gz);
-    	g_angle=0.98*(g_angle+float(gy)*0.01/131) + 0.02*atan2((double)ax,(double)az)*180/PI;
-
-    	/*--- Compute Control surface travel using : 2* sin(angle/2)* chord. Angle for sinus function needs  ---*/
-    	/*--- to be converted in radian (angleDegre = angleRadian *(2*PI)/360)                               ---*/ 
-    	g_travel = g_chordControlSurface * sin((g_angle*(2.0*PI)/360.0)/2.0) * 2.0;
-
-		ESP_LOGD(tagd, "angle %f - travel %f\n",g_angle,g_travel);
-		ESP_LOGD(tagd, "(abs)angle %d - (abs)g_travel %d\n",(int)abs(g_angle), (int)abs(g_travel));
-
-		vTaskDelay(10/portTICK_PERIOD_MS);
+		/*--- Idle : wait for the motion interrupt, or poll it at the loop period of the profile ---*/
+		if(state == MEASURE_IDLE){
+#ifdef MPU_INT_GPIO
+			ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IDLE_REQUEST_MS));
+#else
+			ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(loopPeriodMs));
+#endif
+			target_band_update();		/* a target set while idle */
+			if(!idle_motion())
+				continue;
+
+			idle_exit();
+			state = MEASURE_ACTIVE;
+			stillSince = lastWake = xTaskGetTickCount();
+		}
+
+#if CONFIG_PM_ENABLE
+		if(pmLock != NULL)
+			esp_pm_lock_acquire(pmLock);
+#endif
+
+		/*--- Profile selected through the HTTP API ---*/
+		int request = g_profileRequest;
+		if(request >= 0){
+			g_profileRequest = -1;
+			profile_apply(request);
+			if(!g_profileRequestTransient)
+				acquisition_profile_save(request);	/* not the low battery switch */
+			g_profileRequestTransient = false;
+			jitterRunning = false;		/* rate and DLPF set by the profile, configured again below */
+			if(g_calibrationState != CALIBRATION_DONE)
+				calib_start();			/* windows started again on the new profile                */
+		}
+
+		/*--- Requests of the HTTP API served in this cycle, taken atomically : a request set meanwhile, ---*/
+		/*--- or one that cannot be served yet (calibration running), stays pending.                    ---*/
+		uint32_t serviceable = MEASURE_REQUEST_HINGE;
+		if(g_calibrationState == CALIBRATION_DONE)
+			serviceable |= MEASURE_REQUEST_CALIBRATION;
+		if(g_calibrationState != CALIBRATION_BOOT)
+			serviceable |= MEASURE_REQUEST_REFERENCE;	/* no sensor update during the boot calibration */
+		uint32_t requests = __atomic_fetch_and(&g_measureRequests, ~serviceable, __ATOMIC_ACQ_REL) & serviceable;
+		captureReference = (requests & MEASURE_REQUEST_REFERENCE) != 0;
+
+		/*--- Recalibration requested through the HTTP API : the measure goes on with the current ---*/
+		/*--- offsets until the new ones are swapped in.                                         ---*/
+		if(requests & MEASURE_REQUEST_CALIBRATION){
+			calib_start();
+			g_calibrationState = CALIBRATION_RUNNING;
+		}
+
+#if ESP_MAD_ATTITUDE_3D
+		/*--- Sensor clipped on another surface : the hinge axis is learnt again from the next throw ---*/
+		if(requests & MEASURE_REQUEST_HINGE){
+			for(int i = 0; i < sensorCount; i++){
+				sensors[i].attitude.forgetHinge();
+				hinge_store(&sensors[i], true);
+			}
+		}
+#endif
+
+		/*--- Jitter analysis started / stopped through the HTTP API ---*/
+		bool jitterRequest = jitter_requested();
+		if(jitterRequest != jitterRunning){
+			jitter_configure(jitterRequest);
+			jitterRunning = jitterRequest;
+		}
+
+		/*--- Six-position accelero calibration driven through the HTTP API : the MPU6050 of a new   ---*/
+		/*--- session is sampled without correction and without accelero offsets.                  ---*/
+		int calib = accel_calib_begin();
+		if(calib >= 0 && calib < sensorCount){
+			sensors[calib].accelCal.valid = false;
+			accel_calib_offsets(&sensors[calib], false);
+		}
+
+		/*--- All the MPU6050 are read back-to-back, so the surfaces are sampled at the same time.      ---*/
+		/*--- A sample lost on the bus (after I2Cdev retries and bus recovery) is skipped, the filter of ---*/
+		/*--- the sensor keeps its previous state.                                                       ---*/
+		for(int i = 0; i < sensorCount; i++){
+			measure_sensor_t *s = &sensors[i];
+			s->sampleOk = s->mpu.getMotion6(&s->ax, &s->ay, &s->az, &s->gx, &s->gy, &s->gz, &s->temp);
+			s->timestamp = esp_timer_get_time();
+		}
+		if(jitterRunning)
+			jitter_read(&sensors[0]);
+		update_i2c_stats();
+
+		for(int i = 0; i < sensorCount; i++){
+			measure_sensor_t *s = &sensors[i];
+			if(!s->sampleOk){
+				g_skippedSamples++;
+				continue;
+			}
+			if(g_calibrationState != CALIBRATION_DONE)
+				calib_sample(s);
+			if(g_calibrationState == CALIBRATION_BOOT)
+				continue;
+			accel_calib_sample(i, s->ax, s->ay, s->az, s->accelScale);
+			sensor_update(s);
+		}
+
+		/*--- Calibration windows all done : the new offsets are written before the next sample ---*/
+		if(g_calibrationState != CALIBRATION_DONE && calib_done()){
+			calib_swap();
+			g_calibrationState = CALIBRATION_DONE;
+		}
+
+		accel_cal_t cal;
+		bool clear;
+		calib = accel_calib_end(&cal, &clear);
+		if(calib >= 0 && calib < sensorCount)
+			accel_calib_finish(&sensors[calib], &cal, clear);
+
+		/*--- Publish the results, the second MPU6050 replaces the client board ---*/
+		measure_sensor_t *s = &sensors[0];
+		g_angle = s->angle;
+		g_travel = s->travel;
+		g_still = s->still;
+		g_gyroBias = (s->modelBias[1] + s->gyroBias[1]) / 131.0;
+		g_mpuTemperature = s->temperature;
+		uint32_t spikes = 0, gated = 0;
+		for(int i = 0; i < sensorCount; i++){
+			spikes += sensors[i].prefilter.spikes;
+			gated += sensors[i].prefilter.gated;
+		}
+		g_accelSpikes = spikes;
+		g_accelGated = gated;
+		g_settled = s->settle.settled;
+		g_angleSettled = s->settledAngle;
+		g_travelSettled = s->settledTravel;
+		g_angleConfidence = settle_confidence(&s->settle);
+		if(sensorCount > 1){
+			g_angleSensor2 = sensors[1].settledAngle;
+			g_travelSensor2 = sensors[1].settledTravel;
+		}
+
+		/*--- Target led band, once per sample ---*/
+		target_band_update();
+
+		/*--- Servo sweep capture on the first surface (see esp_mad_sweep.cpp) ---*/
+		if(s->sampleOk)
+			sweep_update(s->timestamp, s->angle);
+
+		/*--- Every surface still for g_idleTimeoutS : low-power idle (0 disables it) ---*/
+		bool allStill = true;
+		for(int i = 0; i < sensorCount; i++)
+			allStill &= sensors[i].still;
+		if(!allStill || g_idleTimeoutS == 0 || sweep_busy() || jitterRunning || g_calibrationState != CALIBRATION_DONE)
+			stillSince = xTaskGetTickCount();
+		else if((xTaskGetTickCount() - stillSince) / configTICK_RATE_HZ >= g_idleTimeoutS){	/* in seconds, up to 65535 */
+			idle_enter();
+			state = MEASURE_IDLE;
+		}
+
+#if CONFIG_PM_ENABLE
+		if(pmLock != NULL)
+			esp_pm_lock_release(pmLock);
+#endif
+
+		ESP_LOGD(TAG, "angle %f - travel %f\n",g_angle,g_travel);
+		ESP_LOGD(TAG, "(abs)angle %d - (abs)g_travel %d\n",(int)abs(g_angle), (int)abs(g_travel));
+
+		if(state == MEASURE_ACTIVE)
+			vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(loopPeriodMs));
 		
 		}
 
@@ -12,12 +12,23 @@
 
 #define _ESP_MAD_TASK_MEASURE_H_
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define MEASURE_MAX_SENSORS 2       /* MPU6050 on the bus, addresses 0x68 (AD0 low) and 0x69 (AD0 high) */
+
+	/*------------------------------------------
+	 * TYPES
+	 *------------------------------------------*/
+	typedef struct measure_sensor measure_sensor_t;
+
 	/*------------------------------------------
 	 * PROTYPES
 	 *------------------------------------------*/
-	void meansensors(void);
-	void calibration(void);
-	void InitMPU6050(void);
 	void task_measure(void*);
+	void measure_target_led(TaskHandle_t task);
 
 #endif
\ No newline at end of file
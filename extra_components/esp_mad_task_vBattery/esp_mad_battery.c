@@ -0,0 +1,136 @@
+/**
+ * @file      esp_mad_battery.c
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Battery state of charge and remaining runtime
+ *
+ * @details   The voltage of a loaded LiPo is below its open circuit voltage by I x Rint. The load
+ *            is estimated from the operating mode : WiFi mode of the board (access point on the
+ *            server, station on the client), rate of the acquisition profile and idle mode. The
+ *            open circuit voltage gives the state of charge through the typical 1S LiPo discharge
+ *            curve, and the remaining runtime is the charge left over the load.
+ *            Under g_lowBatterySoc the low_power acquisition profile is selected, without saving
+ *            it, and the saved profile comes back BATT_LOW_POWER_HYST % above (charger plugged).
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <stdbool.h>
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_mad_battery.h"
+#include "esp_mad_profile.h"
+#include "Esp_mad.h"
+#include "Esp_mad_Globals_Variables.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+
+/*--- Open circuit voltage of a 1S LiPo at 100 %, 95 %, ... 0 % state of charge, mV ---*/
+static const uint16_t lipoCurve[] = {
+    4200, 4150, 4110, 4080, 4020, 3980, 3950, 3910, 3870, 3850, 3840,
+    3820, 3800, 3790, 3770, 3750, 3730, 3710, 3690, 3610, 3270
+};
+
+#define LIPO_CURVE_POINTS   (int)(sizeof(lipoCurve) / sizeof(lipoCurve[0]))
+#define LIPO_CURVE_STEP     (100 / (LIPO_CURVE_POINTS - 1))
+
+static float socFiltered = -1.0f;
+static float runtimeFiltered = -1.0f;
+
+static const char tagd[] = "battery->";
+
+/**
+ *	@fn 		uint8_t battery_soc(uint32_t mv, uint32_t loadMa)
+ *  @brief		State of charge from the battery voltage under load
+ *	@param[in]	mv : battery voltage in mV, loadMa : current drawn during the reading
+ *	@return		state of charge in %, interpolated on the LiPo discharge curve
+ *
+ */
+uint8_t battery_soc(uint32_t mv, uint32_t loadMa)
+{
+    uint32_t ocv = mv + loadMa * BATT_RINT_MOHM / 1000;
+
+    if (ocv >= lipoCurve[0]) {
+        return 100;
+    }
+    for (int i = 1; i < LIPO_CURVE_POINTS; i++) {
+        if (ocv >= lipoCurve[i]) {
+            uint32_t span = lipoCurve[i - 1] - lipoCurve[i];
+            return (uint8_t)(100 - i * LIPO_CURVE_STEP + (ocv - lipoCurve[i]) * LIPO_CURVE_STEP / span);
+        }
+    }
+    return 0;
+}
+
+/**
+ *	@fn 		uint32_t battery_load_ma(void)
+ *  @brief		Current drawn in the present operating mode
+ *	@param[in]	void
+ *	@return		estimated load in mA
+ *
+ */
+uint32_t battery_load_ma(void)
+{
+    uint32_t load = BATT_LOAD_BASE_MA;
+    wifi_mode_t mode = WIFI_MODE_NULL;
+
+    if (esp_wifi_get_mode(&mode) == ESP_OK) {
+        if (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA) {
+            load += BATT_LOAD_AP_MA;
+        } else if (mode == WIFI_MODE_STA) {
+            load += BATT_LOAD_STA_MA;
+        }
+    }
+
+    /*--- The measure loop only runs out of the idle mode (MPU6050 in cycle mode) ---*/
+    if (!g_idle) {
+        const acquisition_profile_t *profile = acquisition_profile_get(g_acquisitionProfile);
+        load += (1000 / profile->loopPeriodMs) * BATT_LOAD_SAMPLE_UA / 1000;
+    }
+    return load;
+}
+
+/**
+ *	@fn 		void battery_update(uint32_t mv)
+ *  @brief		New battery reading : state of charge, runtime and low power profile
+ *	@param[in]	mv : battery voltage in mV
+ *	@return		void
+ *
+ */
+void battery_update(uint32_t mv)
+{
+    uint32_t load = battery_load_ma();
+    float soc = battery_soc(mv, load);
+
+    /*--- Smoothed state of charge, then runtime at the present load ---*/
+    socFiltered = socFiltered < 0.0f ? soc : socFiltered + BATT_SOC_SMOOTHING * (soc - socFiltered);
+    float runtime = socFiltered / 100.0f * BATT_CAPACITY_MAH / load * 60.0f;
+    runtimeFiltered = runtimeFiltered < 0.0f ? runtime : runtimeFiltered + BATT_RUNTIME_SMOOTHING * (runtime - runtimeFiltered);
+
+    g_batteryLoadMa = load;
+    g_batterySoc = (int8_t)(socFiltered + 0.5f);
+    g_batteryRuntimeMin = (int32_t)(runtimeFiltered + 0.5f);
+    ESP_LOGI(tagd, "%d %% (load %d mA), %d min left", (int)g_batterySoc, (int)load, (int)g_batteryRuntimeMin);
+
+    /*--- Low battery : low_power profile, not saved, the saved one is restored once recharged ---*/
+    if (!g_lowBattery && g_batterySoc < g_lowBatterySoc) {
+        int index = acquisition_profile_find("low_power");
+        g_lowBattery = true;
+        if (index >= 0 && index != g_acquisitionProfile) {
+            ESP_LOGW(tagd, "battery under %d %%, low_power profile", (int)g_lowBatterySoc);
+            g_profileRequestTransient = true;
+            g_profileRequest = index;
+        }
+    } else if (g_lowBattery && g_batterySoc >= g_lowBatterySoc + BATT_LOW_POWER_HYST) {
+        int index = acquisition_profile_load();
+        g_lowBattery = false;
+        if (index != g_acquisitionProfile) {
+            g_profileRequestTransient = true;
+            g_profileRequest = index;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ * @file      esp_mad_battery.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     interface for the battery state of charge of the esp_mad_task_vBattery component.
+ *
+ * @details   State of charge of the 1S LiPo from its voltage, corrected by the drop in the cell
+ *            at the estimated load, and remaining runtime at that load. Both are smoothed over
+ *            the readings of task_vBattery().
+ *
+ */
+
+#ifndef _ESP_MAD_BATTERY_H_
+
+#define _ESP_MAD_BATTERY_H_
+
+#include <stdint.h>
+
+	/*------------------------------------------
+	 * DEFINE
+	 *------------------------------------------*/
+	#define BATT_RINT_MOHM          200     /* cell, protection and wiring resistance                     */
+	#define BATT_LOAD_BASE_MA       25      /* CPU, regulator, MPU6050 and leds                            */
+	#define BATT_LOAD_AP_MA         95      /* WiFi access point (server), radio always on                 */
+	#define BATT_LOAD_STA_MA        70      /* WiFi station (client)                                       */
+	#define BATT_LOAD_SAMPLE_UA     150     /* measure loop, per Hz of the acquisition profile            */
+	#define BATT_LOW_POWER_HYST     10      /* % above the threshold to leave the low power profile        */
+	#define BATT_SOC_SMOOTHING      0.3f    /* exponential smoothing of the state of charge, per reading  */
+	#define BATT_RUNTIME_SMOOTHING  0.2f    /* exponential smoothing of the runtime, per reading          */
+
+	/*------------------------------------------
+	 * PROTYPES
+	 *------------------------------------------*/
+	uint8_t  battery_soc(uint32_t mv, uint32_t loadMa);
+	uint32_t battery_load_ma(void);
+	void     battery_update(uint32_t mv);
+
+#endif
@@ -4,127 +4,257 @@
  * @date      june 5th 2021
  * @brief     This task process the measurement of the voltage of the battery
  *
- * @details   This task handles the periodic measurement of the voltage of the battery
- * 
+ * @details   This task handles the periodic measurement of the voltage of the battery.
+ *            The ADC runs in continuous mode : the conversions go by DMA to a frame of
+ *            VBATT_FRAME_SAMPLES results, through the hardware IIR filter. The task sleeps
+ *            until the frame is complete (conversion done interrupt), then stops the ADC,
+ *            averages the settled part of the frame and converts it with the curve fitting
+ *            calibration (eFuse). The reading carries its time and its noise (standard
+ *            deviation of the frame).
+ *
  */
 
 /*-----------------------------------------
- *-            INCLUDES        
+ *-            INCLUDES
  *-----------------------------------------*/
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "driver/gpio.h"
-#include "driver/adc.h"
-//#include "esp_adc/adc_oneshot.h"
-#include "esp_adc_cal.h"
-//#include "esp_adc/adc_cali.h"
-//#include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_filter.h"
+#include "esp_adc/adc_cali.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "esp_attr.h"
 #include "esp_log.h"
-#include "esp_adc_cal_types_legacy.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
 #include "esp_mad_task_vBattery.h"
+#include "esp_mad_battery.h"
 #include "Esp_mad.h"
 #include "Esp_mad_Globals_Variables.h"
 
 /*-----------------------------------------
- *-            LOCALS VARIABLES        
+ *-            LOCALS VARIABLES
  *-----------------------------------------*/
-                                                                         
-static const adc_channel_t channel = ADC_CHANNEL_7;			/* VBAT Sense on ESP_MAD board is connected to IO35, so channel 7                                 */
-static const adc_atten_t atten = ADC_ATTEN_DB_12;		    /* 11 dB attenuation as we use a 4,2 V max battery lipo, divided by 2 because bridge divisor used */   															
+
+static const adc_channel_t channel = (adc_channel_t)BATT_ADC_CHANNEL;	/* VBAT Sense on ESP_MAD board, see ESP_MAD_DEFAULT_BATT_CH                                   */
+static const adc_atten_t atten = ADC_ATTEN_DB_12;		    /* 12 dB attenuation as we use a 4,2 V max battery lipo, divided by 2 because bridge divisor used */
 static const adc_unit_t unit = ADC_UNIT_1;				    /* ADC1 is used													                                  */
-static uint32_t adc_reading = 0;
+static TaskHandle_t vBatteryTask = NULL;
+static uint8_t frame[VBATT_FRAME_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES];
 
 static const char tagd[] = "task_vBattery->";
 
 /**
- *	@fn 		static void check_efuse(void)
- *  @brief		Check if TP and Vref is burned into eFuse	
+ *	@fn 		static bool conversion_done(adc_continuous_handle_t, const adc_continuous_evt_data_t*, void*)
+ *  @brief		ISR, a DMA frame is complete : wakes the task up
+ *	@param[in]	handle, edata, user_data : unused
+ *	@return		true if a higher priority task was woken
+ *
+ */
+static bool IRAM_ATTR conversion_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    BaseType_t woken = pdFALSE;
+
+    vTaskNotifyGiveFromISR(vBatteryTask, &woken);
+    return woken == pdTRUE;
+}
+
+/**
+ *	@fn 		static adc_cali_handle_t calibration_init(void)
+ *  @brief		Curve fitting calibration from the eFuse, line fitting on the chips without it
  *	@param[in]	void
- *	@return		void	
- * 
+ *	@return		calibration handle, NULL if the chip is not calibrated (raw * 2500 / 4095 used)
+ *
  */
-static void check_efuse(void)
+static adc_cali_handle_t calibration_init(void)
 {
-    //Check TP is burned into eFuse
-    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_TP) == ESP_OK) {
-        printf("eFuse Two Point: Supported\n");
-    } else {
-        printf("eFuse Two Point: NOT supported\n");
+    adc_cali_handle_t cali = NULL;
+    esp_err_t err = ESP_ERR_NOT_SUPPORTED;
+
+#if ADC_CALI_SCHEME_CURVE_FITTING_SUPPORTED
+    adc_cali_curve_fitting_config_t cali_config = {
+        .unit_id = unit,
+        .chan = channel,
+        .atten = atten,
+        .bitwidth = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    err = adc_cali_create_scheme_curve_fitting(&cali_config, &cali);
+    if (err == ESP_OK) {
+        ESP_LOGI(tagd, "Calibration scheme : curve fitting");
+    }
+#elif ADC_CALI_SCHEME_LINE_FITTING_SUPPORTED
+    adc_cali_line_fitting_config_t cali_config = {
+        .unit_id = unit,
+        .atten = atten,
+        .bitwidth = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    err = adc_cali_create_scheme_line_fitting(&cali_config, &cali);
+    if (err == ESP_OK) {
+        ESP_LOGI(tagd, "Calibration scheme : line fitting");
     }
+#endif
 
-    //Check Vref is burned into eFuse
-    if (esp_adc_cal_check_efuse(ESP_ADC_CAL_VAL_EFUSE_VREF) == ESP_OK) {
-        printf("eFuse Vref: Supported\n");
-    } else {
-        printf("eFuse Vref: NOT supported\n");
+    if (err != ESP_OK) {
+        ESP_LOGW(tagd, "eFuse not burnt, ADC not calibrated");
+        cali = NULL;
+    }
+    return cali;
+}
+
+/**
+ *	@fn 		static int raw_to_mv(adc_cali_handle_t cali, int raw)
+ *  @brief		ADC raw to mV at the ADC pin
+ *	@param[in]	cali : calibration handle or NULL, raw : ADC result
+ *	@return		voltage in mV
+ *
+ */
+static int raw_to_mv(adc_cali_handle_t cali, int raw)
+{
+    int mv = raw * 2500 / ((1 << SOC_ADC_DIGI_MAX_BITWIDTH) - 1);
+
+    if (cali != NULL) {
+        adc_cali_raw_to_voltage(cali, raw, &mv);
     }
+    return mv;
 }
 
 /**
- *	@fn 		static void print_char_val_type(esp_adc_cal_value_t)
- *  @brief		Print the caracterization method used for calibration	
- *	@param[in]	esp_adc_cal_value_t
- *	@return		void	
- * 
+ *	@fn 		static adc_continuous_handle_t adc_init(void)
+ *  @brief		Continuous mode on the battery channel, one pattern, hardware IIR filter
+ *	@param[in]	void
+ *	@return		continuous mode handle, NULL on error
+ *
  */
-static void print_char_val_type(esp_adc_cal_value_t val_type)
+static adc_continuous_handle_t adc_init(void)
 {
-    if (val_type == ESP_ADC_CAL_VAL_EFUSE_TP) {
-        ESP_LOGI(tagd, "Characterized using Two Point Value\n");
-    } else if (val_type == ESP_ADC_CAL_VAL_EFUSE_VREF) {
-        ESP_LOGI(tagd, "Characterized using eFuse Vref\n");
+    adc_continuous_handle_t handle = NULL;
+
+    adc_continuous_handle_cfg_t handle_config = {
+        .max_store_buf_size = 2 * sizeof(frame),
+        .conv_frame_size = sizeof(frame),
+    };
+    if (adc_continuous_new_handle(&handle_config, &handle) != ESP_OK) {
+        ESP_LOGE(tagd, "ADC continuous mode not available");
+        return NULL;
+    }
+
+    adc_digi_pattern_config_t pattern = {
+        .atten = atten,
+        .channel = channel,
+        .unit = unit,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    adc_continuous_config_t config = {
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = VBATT_SAMPLE_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+    };
+    ESP_ERROR_CHECK(adc_continuous_config(handle, &config));
+
+#if SOC_ADC_DIG_IIR_FILTER_SUPPORTED
+    adc_iir_filter_handle_t filter = NULL;
+    adc_continuous_iir_filter_config_t filter_config = {
+        .unit = unit,
+        .channel = channel,
+        .coeff = VBATT_IIR_COEFF,
+    };
+    if (adc_new_continuous_iir_filter(handle, &filter_config, &filter) == ESP_OK) {
+        adc_continuous_iir_filter_enable(filter);
     } else {
-        ESP_LOGI(tagd, "Characterized using Default Vref\n");
+        ESP_LOGW(tagd, "ADC IIR filter not available");
     }
+#endif
+
+    adc_continuous_evt_cbs_t callbacks = {
+        .on_conv_done = conversion_done,
+    };
+    ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(handle, &callbacks, NULL));
+
+    return handle;
 }
 
 /**
  *	@fn 		void task_vBattery(void*)
- *  @brief		Periodic Battery's voltage measurement	
+ *  @brief		Periodic Battery's voltage measurement
  *	@param[in]	void*
- *	@return		void	
- * 
+ *	@return		void
+ *
  */
 void task_vBattery(void* ignore) {
-    
-    /*--- Check if Two Point or Vref are burned into eFuse ---*/
-    check_efuse();
 
-    /*--- ADC Initialization with 12 bit resolution ---*/
+    vBatteryTask = xTaskGetCurrentTaskHandle();
+
+    /*--- ADC Initialization, continuous mode with DMA ---*/
 	ESP_LOGI(tagd,"ADC initialization ...");
-    adc1_config_width(ADC_WIDTH_BIT_12);
-    adc1_config_channel_atten(channel, atten);
+    adc_continuous_handle_t handle = adc_init();
+    if (handle == NULL) {
+        vTaskDelete(NULL);
+        return;
+    }
 
-    /*--- Characterize ADC ---*/
-    esp_adc_cal_characteristics_t *adc_chars = calloc(1, sizeof(esp_adc_cal_characteristics_t));  
-    esp_adc_cal_value_t val_type = esp_adc_cal_characterize(unit, atten, ADC_WIDTH_BIT_12, DEFAULT_VREF, adc_chars);
-    print_char_val_type(val_type);
+    /*--- Calibration scheme burnt in eFuse ---*/
+    adc_cali_handle_t cali = calibration_init();
 
 	/*--- Infinite loop ---*/
 	while(1){
-	    
-		/*--- ADC Reading ---*/
-		adc_reading = 0;
-        for (int i = 0; i < NB_ADC_SAMPLE; i++) {
-                adc_reading += adc1_get_raw((adc1_channel_t)channel);
+
+		/*--- One frame : the task sleeps until the DMA has filled it ---*/
+        uint32_t length = 0;
+        adc_continuous_flush_pool(handle);
+        ulTaskNotifyTake(pdTRUE, 0);
+        ESP_ERROR_CHECK(adc_continuous_start(handle));
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000 * VBATT_FRAME_SAMPLES / VBATT_SAMPLE_HZ + 500)) == 0 ||
+            adc_continuous_read(handle, frame, sizeof(frame), &length, 0) != ESP_OK) {
+            ESP_LOGW(tagd, "ADC frame timeout");
+            length = 0;
+        }
+        adc_continuous_stop(handle);
+
+        /*--- Mean and standard deviation of the settled conversions (IIR filter output) ---*/
+        uint32_t count = 0;
+        uint64_t sum = 0, sumSq = 0;
+        for (uint32_t i = VBATT_SETTLE_SAMPLES * SOC_ADC_DIGI_RESULT_BYTES; i < length; i += SOC_ADC_DIGI_RESULT_BYTES) {
+            adc_digi_output_data_t *p = (adc_digi_output_data_t*)&frame[i];
+            if (p->type2.unit != unit || p->type2.channel != channel) {
+                continue;
+            }
+            sum += p->type2.data;
+            sumSq += (uint64_t)p->type2.data * p->type2.data;
+            count++;
+        }
+
+        if (count > 0) {
+            float mean = (float)sum / count;
+            float variance = (float)sumSq / count - mean * mean;
+            float std = variance > 0.0f ? sqrtf(variance) : 0.0f;
+            int raw = (int)(mean + 0.5f);
+
+            /*--- ADC convertion to voltage in mV 																	---*/
+            /*--- note : voltage is multiply by 2 because we have a brigde resistor divider of 100kOhm each         ---*/
+            /*--- see the ESP_MAD_BOARD schematic for more information												---*/
+            int mv = raw_to_mv(cali, raw);
+            g_voltage = mv * VBATT_DIVIDER;
+            g_voltageNoise = (raw_to_mv(cali, (int)(mean + std + 0.5f)) - mv) * VBATT_DIVIDER;
+            g_voltageTimestamp = esp_timer_get_time();
+            ESP_LOGI(tagd, "Raw: %d\tVoltage: %dmV\tNoise: %dmV (%d samples)", raw, (int)g_voltage, (int)g_voltageNoise, (int)count);
+
+            /*--- State of charge, runtime and low battery profile (see esp_mad_battery.c) ---*/
+            battery_update(g_voltage);
         }
-        adc_reading /= NB_ADC_SAMPLE;
-        
-		/*--- ADC convertion to voltage in mV 																	---*/
-		/*--- note : voltage is multiply by 2 because we have a brigde resistor divider of 100kOhm each on IO35 ---*/
-		/*--- see the ESP_MAD_BOARD schematic for more information												---*/
-        g_voltage = (esp_adc_cal_raw_to_voltage(adc_reading, adc_chars))*2;
-        ESP_LOGI(tagd, "Raw: %d\tVoltage: %dmV\n", (int)adc_reading, (int)g_voltage);
-
-		/*--- In order to reduce the power consumption, voltage is read in low frequency						---*/
-		vTaskDelay(30000/portTICK_PERIOD_MS);
-		
+
+		/*--- In order to reduce the power consumption, voltage is read in low frequency, ADC stopped ---*/
+		vTaskDelay(pdMS_TO_TICKS(VBATT_PERIOD_MS));
+
 		}
 
     /*--- this part will not be executed but we stick the free rtos recomandation ---*/
 	vTaskDelete(NULL);
 
-} /* end task_measure() */
+} /* end task_vBattery() */
@@ -5,7 +5,7 @@
  * @brief     interface for the esp_mad_task_vBattery component.
  *
  * @details   Protypes and define for the component.
- * 
+ *
  */
 
 #ifndef _ESP_MAD_TASK_VBATTERY_H_
@@ -16,12 +16,15 @@
 	 * PROTYPES
 	 *------------------------------------------*/
 	void task_vBattery(void*);
-	static void print_char_val_type(esp_adc_cal_value_t);
 
 	/*------------------------------------------
 	 * DEFINE
 	 *------------------------------------------*/
-	#define DEFAULT_VREF    1100        /* As default 1100 mV for ADC calibration as recommended by espressif */
-	#define NB_ADC_SAMPLE   64          /* Samples number used to read the ADC */ 
+	#define VBATT_SAMPLE_HZ         1000        /* ADC continuous conversion rate (C3 : 611 Hz minimum)              */
+	#define VBATT_FRAME_SAMPLES     256         /* conversions per DMA frame, one frame per reading                  */
+	#define VBATT_SETTLE_SAMPLES    128         /* first conversions of the frame dropped, IIR filter settling       */
+	#define VBATT_IIR_COEFF         ADC_DIGI_IIR_FILTER_COEFF_16    /* hardware averaging of the conversions  */
+	#define VBATT_DIVIDER           2           /* 100 kOhm / 100 kOhm bridge on the battery sense pin               */
+	#define VBATT_PERIOD_MS         30000       /* one reading every 30 s, the ADC is stopped in between             */
 
-#endif
\ No newline at end of file
+#endif
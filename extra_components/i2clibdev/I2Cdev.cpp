@@ -36,13 +36,13 @@ THE SOFTWARE.
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include "sdkconfig.h"
+#include <string.h>
+#include <driver/gpio.h>
+#include <esp_rom_sys.h>
 
 #include "I2Cdev.h"
 
-#define I2C_NUM I2C_NUM_0
-
-#undef ESP_ERROR_CHECK
-#define ESP_ERROR_CHECK(x)   do { esp_err_t rc = (x); if (rc != ESP_OK) { ESP_LOGE("err", "esp_err_t = %d", rc); /*assert(0 && #x);*/} } while(0);
+static const char TAG[] = "I2Cdev";
 
 /** Default constructor.
  */
@@ -55,6 +55,32 @@ void I2Cdev::initialize() {
 
 }
 
+/** Configure and install the I2C master driver used by all the devices.
+ * The configuration is kept so the bus can be re-initialized by recoverBus().
+ * @param port I2C port number
+ * @param sda SDA gpio
+ * @param scl SCL gpio
+ * @param clkSpeed SCL frequency in Hz
+ * @return ESP_OK or the error returned by the i2c driver
+ */
+esp_err_t I2Cdev::initialize(i2c_port_t port, gpio_num_t sda, gpio_num_t scl, uint32_t clkSpeed) {
+    esp_err_t rc;
+
+    memset(&busConfig, 0, sizeof(busConfig));
+    busConfig.mode = I2C_MODE_MASTER;
+    busConfig.sda_io_num = sda;
+    busConfig.scl_io_num = scl;
+    busConfig.sda_pullup_en = GPIO_PULLUP_ENABLE;
+    busConfig.scl_pullup_en = GPIO_PULLUP_ENABLE;
+    busConfig.master.clk_speed = clkSpeed;
+    busPort = port;
+
+    rc = i2c_param_config(busPort, &busConfig);
+    if (rc == ESP_OK)
+        rc = i2c_driver_install(busPort, I2C_MODE_MASTER, 0, 0, 0);
+    return rc;
+}
+
 /** Enable or disable I2C
  * @param isEnabled true = enable, false = disable
  */
@@ -65,20 +91,144 @@ void I2Cdev::enable(bool isEnabled) {
 /** Default timeout value for read operations.
  */
 uint16_t I2Cdev::readTimeout = I2CDEV_DEFAULT_READ_TIMEOUT;
+
+/** Bus configuration, saved by initialize() for the bus recovery.
+ */
+i2c_port_t I2Cdev::busPort = I2C_NUM_0;
+i2c_config_t I2Cdev::busConfig;
+
+/** Error counters, one slot per device which had at least one failed transaction.
+ */
+I2Cdev_stats_t I2Cdev::stats[I2CDEV_STATS_MAX_DEVICES];
+
+/** Register shadows, one slot per device which enabled it.
+ */
+I2Cdev_shadow_t I2Cdev::shadows[I2CDEV_SHADOW_MAX_DEVICES];
+
+/** Enable the register shadow of a device.
+ * Once enabled, reads of the registers flagged in cacheMap are served from RAM
+ * after their first bus access, so the read-modify-write done by writeBit() and
+ * writeBits() only costs the write transaction. Writes which would not change a
+ * shadowed register are dropped. The shadow starts empty (all entries invalid).
+ * @param devAddr I2C slave device address
+ * @param cacheMap Bitmap of the cacheable registers (I2CDEV_SHADOW_MAP_SIZE bytes, must stay valid)
+ * @return Status of operation (true = success, false = no free slot)
+ */
+bool I2Cdev::enableShadow(uint8_t devAddr, const uint8_t *cacheMap) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow == NULL)
+        shadow = shadowFind(0);
+    if (shadow == NULL)
+        return false;
+
+    shadow->devAddr = devAddr;
+    shadow->cacheMap = cacheMap;
+    memset(shadow->valid, 0, sizeof(shadow->valid));
+    return true;
+}
+
+/** Disable the register shadow of a device and release its slot.
+ * @param devAddr I2C slave device address
+ */
+void I2Cdev::disableShadow(uint8_t devAddr) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow != NULL)
+        shadow->devAddr = 0;
+}
+
+/** Invalidate the whole register shadow of a device (e.g. after a device reset).
+ * @param devAddr I2C slave device address
+ */
+void I2Cdev::invalidateShadow(uint8_t devAddr) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow != NULL)
+        memset(shadow->valid, 0, sizeof(shadow->valid));
+}
+
+/** Invalidate a single shadowed register (e.g. after setting a self-clearing bit).
+ * @param devAddr I2C slave device address
+ * @param regAddr Register to invalidate
+ */
+void I2Cdev::invalidateShadow(uint8_t devAddr, uint8_t regAddr) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow != NULL && regAddr < I2CDEV_SHADOW_SIZE)
+        shadow->valid[regAddr >> 3] &= ~(1 << (regAddr & 7));
+}
+
+/** Look for the shadow slot owned by a device.
+ * @param devAddr I2C slave device address (0 to get a free slot)
+ * @return Pointer on the slot, NULL if none
+ */
+I2Cdev_shadow_t *I2Cdev::shadowFind(uint8_t devAddr) {
+    for (int i = 0; i < I2CDEV_SHADOW_MAX_DEVICES; i++) {
+        if (shadows[i].devAddr == devAddr)
+            return &shadows[i];
+    }
+    return NULL;
+}
+
+/** Serve a read from the shadow.
+ * @return true if every requested register is cacheable and valid, data is then filled
+ */
+bool I2Cdev::shadowRead(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow == NULL || (uint16_t)regAddr + length > I2CDEV_SHADOW_SIZE)
+        return false;
+
+    for (uint8_t reg = regAddr; reg < regAddr + length; reg++) {
+        if (!(shadow->valid[reg >> 3] & (1 << (reg & 7))))
+            return false;
+    }
+    memcpy(data, &shadow->value[regAddr], length);
+    return true;
+}
+
+/** Check if a write would leave the shadowed registers unchanged.
+ * @return true if every written register is cacheable, valid and already holds the data
+ */
+bool I2Cdev::shadowMatches(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t *data) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow == NULL || (uint16_t)regAddr + length > I2CDEV_SHADOW_SIZE)
+        return false;
+
+    for (uint8_t i = 0; i < length; i++) {
+        uint8_t reg = regAddr + i;
+        if (!(shadow->valid[reg >> 3] & (1 << (reg & 7))) || shadow->value[reg] != data[i])
+            return false;
+    }
+    return true;
+}
+
+/** Store the value of registers just read from or written to the device.
+ * Only the cacheable registers are recorded.
+ */
+void I2Cdev::shadowUpdate(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t *data) {
+    I2Cdev_shadow_t *shadow = shadowFind(devAddr);
+    if (shadow == NULL)
+        return;
+
+    for (uint8_t i = 0; i < length && (uint16_t)regAddr + i < I2CDEV_SHADOW_SIZE; i++) {
+        uint8_t reg = regAddr + i;
+        if (shadow->cacheMap[reg >> 3] & (1 << (reg & 7))) {
+            shadow->value[reg] = data[i];
+            shadow->valid[reg >> 3] |= (1 << (reg & 7));
+        }
+    }
+}
+
 /** Read a single bit from an 8-bit device register.
  * @param devAddr I2C slave device address
  * @param regAddr Register regAddr to read from
  * @param bitNum Bit position to read (0-7)
  * @param data Container for single bit value
  * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
- * @return Status of read operation (true = success)
+ * @return Status of read operation (1 = success, -1 = bus error)
  */
 int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout) {
-
-
-	uint8_t b;
-    uint8_t count = readByte(devAddr, regAddr, &b, timeout);
-    *data = b & (1 << bitNum);
+    uint8_t b;
+    int8_t count = readByte(devAddr, regAddr, &b, timeout);
+    if (count > 0)
+        *data = b & (1 << bitNum);
     return count;
 }
 
@@ -89,7 +239,7 @@ int8_t I2Cdev::readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t
  * @param length Number of bits to read (not more than 8)
  * @param data Container for right-aligned value (i.e. '101' read from any bitStart position will equal 0x05)
  * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
- * @return Status of read operation (true = success)
+ * @return Status of read operation (1 = success, -1 = bus error)
  */
 int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint8_t *data, uint16_t timeout) {
     // 01101001 read byte
@@ -97,8 +247,9 @@ int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint
     //    xxx   args: bitStart=4, length=3
     //    010   masked
     //   -> 010 shifted
-    uint8_t count, b;
-    if ((count = readByte(devAddr, regAddr, &b, timeout)) != 0) {
+    int8_t count;
+    uint8_t b;
+    if ((count = readByte(devAddr, regAddr, &b, timeout)) > 0) {
         uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         b &= mask;
         b >>= (bitStart - length + 1);
@@ -112,36 +263,33 @@ int8_t I2Cdev::readBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint
  * @param regAddr Register regAddr to read from
  * @param data Container for byte value read from device
  * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
- * @return Status of read operation (true = success)
+ * @return Status of read operation (1 = success, -1 = bus error)
  */
 int8_t I2Cdev::readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout) {
-    return readBytes(devAddr, regAddr, 1, data, timeout);
+    return (int8_t)readBytes(devAddr, regAddr, 1, data, timeout);
 }
 
 /** Read multiple bytes from an 8-bit device register.
+ * The register address is sent and the data read back in a single transaction
+ * (repeated start). Failed transactions are retried, see transferRetry().
  * @param devAddr I2C slave device address
  * @param regAddr First register regAddr to read from
  * @param length Number of bytes to read
  * @param data Buffer to store read data in
  * @param timeout Optional read timeout in milliseconds (0 to disable, leave off to use default class value in I2Cdev::readTimeout)
- * @return I2C_TransferReturn_TypeDef http://downloads.energymicro.com/documentation/doxygen/group__I2C.html
+ * @return Number of bytes read (up to 255, hence int16_t), -1 on bus error (data content is then undefined)
  */
-int8_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
-	i2c_cmd_handle_t cmd;
-	SelectRegister(devAddr, regAddr);
+int16_t I2Cdev::readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout) {
+	if (length == 0)
+		return -1;
 
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_READ, 1));
+	if (shadowRead(devAddr, regAddr, length, data))
+		return length;
 
-	if(length>1)
-		ESP_ERROR_CHECK(i2c_master_read(cmd, data, length-1, (i2c_ack_type_t)0));
+	if (transferRetry(devAddr, regAddr, NULL, 0, data, length, timeout) != ESP_OK)
+		return -1;
 
-	ESP_ERROR_CHECK(i2c_master_read_byte(cmd, data+length-1, (i2c_ack_type_t)1));
-
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+	shadowUpdate(devAddr, regAddr, length, data);
 
 	return length;
 }
@@ -150,20 +298,11 @@ bool I2Cdev::writeWord(uint8_t devAddr, uint8_t regAddr, uint16_t data){
 
 	uint8_t data1[] = {(uint8_t)(data>>8), (uint8_t)(data & 0xff)};
 //	uint8_t data2[] = {(uint8_t)(data & 0xff), (uint8_t)(data>>8)};
-	writeBytes(devAddr, regAddr, 2, data1);
-	return true;
+	return writeBytes(devAddr, regAddr, 2, data1);
 }
 
 void I2Cdev::SelectRegister(uint8_t dev, uint8_t reg){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (dev << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, reg, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+	transferRetry(dev, reg, NULL, 0, NULL, 0, readTimeout);
 }
 
 /** write a single bit in an 8-bit device register.
@@ -175,7 +314,8 @@ void I2Cdev::SelectRegister(uint8_t dev, uint8_t reg){
  */
 bool I2Cdev::writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data) {
     uint8_t b;
-    readByte(devAddr, regAddr, &b);
+    if (readByte(devAddr, regAddr, &b) <= 0)
+        return false;
     b = (data != 0) ? (b | (1 << bitNum)) : (b & ~(1 << bitNum));
     return writeByte(devAddr, regAddr, b);
 }
@@ -197,7 +337,7 @@ bool I2Cdev::writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8
     // 10100011 original & ~mask
     // 10101011 masked | value
     uint8_t b = 0;
-    if (readByte(devAddr, regAddr, &b) != 0) {
+    if (readByte(devAddr, regAddr, &b) > 0) {
         uint8_t mask = ((1 << length) - 1) << (bitStart - length + 1);
         data <<= (bitStart - length + 1); // shift data into correct position
         data &= mask; // zero all non-important bits in data
@@ -216,40 +356,206 @@ bool I2Cdev::writeBits(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8
  * @return Status of operation (true = success)
  */
 bool I2Cdev::writeByte(uint8_t devAddr, uint8_t regAddr, uint8_t data) {
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data, 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
-
-	return true;
+	return writeBytes(devAddr, regAddr, 1, &data);
 }
 
-/** Write single byte to an 8-bit device register.
+/** Write multiple bytes to an 8-bit device register.
  * @param devAddr I2C slave device address
- * @param regAddr Register address to write to
+ * @param regAddr First register address to write to
  * @param length Number of bytes to write
  * @param data Array of bytes to write
  * @return Status of operation (true = success)
  */
 bool I2Cdev::writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data){
-	i2c_cmd_handle_t cmd;
-
-	cmd = i2c_cmd_link_create();
-	ESP_ERROR_CHECK(i2c_master_start(cmd));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, regAddr, 1));
-	ESP_ERROR_CHECK(i2c_master_write(cmd, data, length-1, 0));
-	ESP_ERROR_CHECK(i2c_master_write_byte(cmd, data[length-1], 1));
-	ESP_ERROR_CHECK(i2c_master_stop(cmd));
-	ESP_ERROR_CHECK(i2c_master_cmd_begin(I2C_NUM, cmd, 1000/portTICK_PERIOD_MS));
-	i2c_cmd_link_delete(cmd);
+	if (length == 0)
+		return false;
+
+	if (shadowMatches(devAddr, regAddr, length, data))
+		return true;
+
+	if (transferRetry(devAddr, regAddr, data, length, NULL, 0, readTimeout) != ESP_OK)
+		return false;
+
+	shadowUpdate(devAddr, regAddr, length, data);
+
 	return true;
 }
 
+/** Get the error counters of a device.
+ * @param devAddr I2C slave device address
+ * @param devStats Container for the counters (all 0 if the device never failed)
+ */
+void I2Cdev::getStats(uint8_t devAddr, I2Cdev_stats_t *devStats) {
+    I2Cdev_stats_t *slot = statsFind(devAddr, false);
+    if (slot != NULL) {
+        *devStats = *slot;
+    } else {
+        memset(devStats, 0, sizeof(*devStats));
+        devStats->devAddr = devAddr;
+    }
+}
 
+/** Look for the counters slot of a device.
+ * @param devAddr I2C slave device address
+ * @param create Allocate a free slot if the device has none
+ * @return Pointer on the slot, NULL if none
+ */
+I2Cdev_stats_t *I2Cdev::statsFind(uint8_t devAddr, bool create) {
+    for (int i = 0; i < I2CDEV_STATS_MAX_DEVICES; i++) {
+        if (stats[i].devAddr == devAddr)
+            return &stats[i];
+    }
+    if (create) {
+        for (int i = 0; i < I2CDEV_STATS_MAX_DEVICES; i++) {
+            if (stats[i].devAddr == 0) {
+                stats[i].devAddr = devAddr;
+                return &stats[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/** Run a single register transaction on the bus, without retry.
+ * Write: START, addr+W, reg, data..., STOP.
+ * Read:  START, addr+W, reg, RESTART, addr+R, data..., STOP.
+ * @param devAddr I2C slave device address
+ * @param regAddr Register address
+ * @param wdata Bytes to write after the register address (NULL if none)
+ * @param wlen Number of bytes to write
+ * @param rdata Buffer for the bytes to read (NULL if none)
+ * @param rlen Number of bytes to read
+ * @param timeout Transaction timeout in milliseconds
+ * @return ESP_OK or the error returned by the i2c driver
+ */
+esp_err_t I2Cdev::transfer(uint8_t devAddr, uint8_t regAddr, const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen, uint16_t timeout) {
+	esp_err_t rc;
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+	if (cmd == NULL)
+		return ESP_ERR_NO_MEM;
+
+	rc = i2c_master_start(cmd);
+	if (rc == ESP_OK) rc = i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1);
+	if (rc == ESP_OK) rc = i2c_master_write_byte(cmd, regAddr, 1);
+	if (rc == ESP_OK && wlen > 0) rc = i2c_master_write(cmd, wdata, wlen, 1);
+	if (rc == ESP_OK && rlen > 0) {
+		rc = i2c_master_start(cmd);
+		if (rc == ESP_OK) rc = i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_READ, 1);
+		if (rc == ESP_OK) rc = i2c_master_read(cmd, rdata, rlen, I2C_MASTER_LAST_NACK);
+	}
+	if (rc == ESP_OK) rc = i2c_master_stop(cmd);
+	if (rc == ESP_OK) rc = i2c_master_cmd_begin(busPort, cmd, timeout ? pdMS_TO_TICKS(timeout) + 1 : portMAX_DELAY);
+
+	i2c_cmd_link_delete(cmd);
+	return rc;
+}
+
+/** Run a register transaction, retrying on failure.
+ * A failed attempt is retried after a short exponential backoff. Before the last
+ * attempt (or straight away on a bus timeout, the symptom of a slave holding SDA)
+ * the bus is recovered. Counters of the device are updated accordingly, so the
+ * caller only has to deal with the final status.
+ * @return ESP_OK or the error of the last attempt
+ */
+esp_err_t I2Cdev::transferRetry(uint8_t devAddr, uint8_t regAddr, const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen, uint16_t timeout) {
+	esp_err_t rc = ESP_OK;
+	bool recovered = false;
+
+	for (uint8_t attempt = 0; attempt <= I2CDEV_MAX_RETRIES; attempt++) {
+		if (attempt > 0) {
+			I2Cdev_stats_t *slot = statsFind(devAddr, true);
+
+			if (!recovered && (rc == ESP_ERR_TIMEOUT || attempt == I2CDEV_MAX_RETRIES)) {
+				recovered = true;
+				if (recoverBus() == ESP_OK && slot != NULL)
+					slot->recoveries++;
+			} else {
+				esp_rom_delay_us(I2CDEV_RETRY_BACKOFF_US << (attempt - 1));
+			}
+			if (slot != NULL)
+				slot->retries++;
+		}
+
+		rc = transfer(devAddr, regAddr, wdata, wlen, rdata, rlen, timeout);
+		if (rc == ESP_OK)
+			return ESP_OK;
+	}
+
+	I2Cdev_stats_t *slot = statsFind(devAddr, true);
+	if (slot != NULL)
+		slot->errors++;
+	ESP_LOGW(TAG, "dev 0x%02x reg 0x%02x : transfer failed (%s)", devAddr, regAddr, esp_err_to_name(rc));
+
+	return rc;
+}
+
+/** Check whether a device acknowledges its address.
+ * Single attempt, no retry, no bus recovery and no error counted: meant to
+ * detect optional devices without disturbing the bus.
+ * @param devAddr I2C slave device address
+ * @return true if the address was acknowledged
+ */
+bool I2Cdev::probe(uint8_t devAddr) {
+	esp_err_t rc;
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create();
+
+	if (cmd == NULL)
+		return false;
+
+	rc = i2c_master_start(cmd);
+	if (rc == ESP_OK) rc = i2c_master_write_byte(cmd, (devAddr << 1) | I2C_MASTER_WRITE, 1);
+	if (rc == ESP_OK) rc = i2c_master_stop(cmd);
+	if (rc == ESP_OK) rc = i2c_master_cmd_begin(busPort, cmd, pdMS_TO_TICKS(readTimeout) + 1);
+
+	i2c_cmd_link_delete(cmd);
+	return rc == ESP_OK;
+}
+
+/** Free a stuck bus and re-install the i2c driver.
+ * A slave interrupted in the middle of a read may keep SDA low forever. Up to
+ * nine clocks are sent on SCL until SDA is released, followed by a STOP
+ * condition, then the driver is re-installed with the initialize() configuration.
+ * @return ESP_OK or the error returned by the i2c driver
+ */
+esp_err_t I2Cdev::recoverBus() {
+	gpio_num_t sda = (gpio_num_t)busConfig.sda_io_num;
+	gpio_num_t scl = (gpio_num_t)busConfig.scl_io_num;
+	esp_err_t rc;
+
+	if (busConfig.mode != I2C_MODE_MASTER)
+		return ESP_ERR_INVALID_STATE;			/* initialize() not called, nothing to recover */
+
+	i2c_driver_delete(busPort);
+
+	gpio_set_direction(sda, GPIO_MODE_INPUT_OUTPUT_OD);
+	gpio_set_direction(scl, GPIO_MODE_INPUT_OUTPUT_OD);
+	gpio_set_pull_mode(sda, GPIO_PULLUP_ONLY);
+	gpio_set_pull_mode(scl, GPIO_PULLUP_ONLY);
+	gpio_set_level(sda, 1);
+
+	for (int i = 0; i < 9 && gpio_get_level(sda) == 0; i++) {
+		gpio_set_level(scl, 0);
+		esp_rom_delay_us(5);
+		gpio_set_level(scl, 1);
+		esp_rom_delay_us(5);
+	}
+
+	/*--- STOP : SDA rising while SCL is high ---*/
+	gpio_set_level(scl, 0);
+	esp_rom_delay_us(5);
+	gpio_set_level(sda, 0);
+	esp_rom_delay_us(5);
+	gpio_set_level(scl, 1);
+	esp_rom_delay_us(5);
+	gpio_set_level(sda, 1);
+	esp_rom_delay_us(5);
+
+	rc = i2c_param_config(busPort, &busConfig);
+	if (rc == ESP_OK)
+		rc = i2c_driver_install(busPort, I2C_MODE_MASTER, 0, 0, 0);
+
+	ESP_LOGW(TAG, "bus recovery %s", rc == ESP_OK ? "done" : "failed");
+
+	return rc;
+}
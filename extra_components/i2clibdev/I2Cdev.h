@@ -46,13 +46,43 @@ THE SOFTWARE.
 #define I2C_SCL_MODE gpioModeWiredAnd
 #define I2C_SCL_DOUT 1
 
-#define I2CDEV_DEFAULT_READ_TIMEOUT 1000
+#define I2CDEV_DEFAULT_READ_TIMEOUT 20    // ms, a 14 bytes burst at 400 kHz takes ~0.4 ms
+
+#define I2CDEV_MAX_RETRIES          3     // attempts after the first failed one
+#define I2CDEV_RETRY_BACKOFF_US     100   // first retry delay, doubled on each attempt
+#define I2CDEV_STATS_MAX_DEVICES    4     // devices with their own error counters
+
+/** Bus error counters of one device.
+ */
+typedef struct {
+    uint8_t devAddr;                            // 0 = free slot
+    uint32_t errors;                            // transactions given up after all retries
+    uint32_t retries;                           // attempts re-run after a failure
+    uint32_t recoveries;                        // bus recoveries (SCL toggling + driver re-install)
+} I2Cdev_stats_t;
+
+#define I2CDEV_SHADOW_MAX_DEVICES   2     // devices that can own a register shadow at the same time
+#define I2CDEV_SHADOW_SIZE          128   // shadowed register address space (0x00 - 0x7F)
+#define I2CDEV_SHADOW_MAP_SIZE      (I2CDEV_SHADOW_SIZE / 8)
+
+/** Register shadow of one device.
+ * cacheMap is a bitmap (bit n of byte n/8 = register n) supplied by the device
+ * class, telling which registers hold plain configuration that only changes when
+ * written by the host. valid tracks which of those entries mirror the device.
+ */
+typedef struct {
+    uint8_t devAddr;                            // 0 = free slot
+    const uint8_t *cacheMap;
+    uint8_t valid[I2CDEV_SHADOW_MAP_SIZE];
+    uint8_t value[I2CDEV_SHADOW_SIZE];
+} I2Cdev_shadow_t;
 
 class I2Cdev {
     public:
         I2Cdev();
 
         static void initialize();
+        static esp_err_t initialize(i2c_port_t port, gpio_num_t sda, gpio_num_t scl, uint32_t clkSpeed);
         static void enable(bool isEnabled);
 
         static int8_t readBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
@@ -61,7 +91,7 @@ class I2Cdev {
         //TODO static int8_t readBitsW(uint8_t devAddr, uint8_t regAddr, uint8_t bitStart, uint8_t length, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
         static int8_t readByte(uint8_t devAddr, uint8_t regAddr, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
         //TODO static int8_t readWord(uint8_t devAddr, uint8_t regAddr, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
-        static int8_t readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
+        static int16_t readBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data, uint16_t timeout=I2Cdev::readTimeout);
         //TODO static int8_t readWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data, uint16_t timeout=I2Cdev::readTimeout);
 
         static bool writeBit(uint8_t devAddr, uint8_t regAddr, uint8_t bitNum, uint8_t data);
@@ -73,11 +103,35 @@ class I2Cdev {
         static bool writeBytes(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data);
         //TODO static bool writeWords(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint16_t *data);
 
+        static bool enableShadow(uint8_t devAddr, const uint8_t *cacheMap);
+        static void disableShadow(uint8_t devAddr);
+        static void invalidateShadow(uint8_t devAddr);
+        static void invalidateShadow(uint8_t devAddr, uint8_t regAddr);
+
+        static void getStats(uint8_t devAddr, I2Cdev_stats_t *devStats);
+        static esp_err_t recoverBus();
+        static bool probe(uint8_t devAddr);
+
         static uint16_t readTimeout;
 
     //private:
         static void SelectRegister(uint8_t dev, uint8_t reg);
         //static I2C_TransferReturn_TypeDef transfer(I2C_TransferSeq_TypeDef *seq, uint16_t timeout=I2Cdev::readTimeout);
+
+    private:
+        static esp_err_t transfer(uint8_t devAddr, uint8_t regAddr, const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen, uint16_t timeout);
+        static esp_err_t transferRetry(uint8_t devAddr, uint8_t regAddr, const uint8_t *wdata, uint8_t wlen, uint8_t *rdata, uint8_t rlen, uint16_t timeout);
+        static I2Cdev_stats_t *statsFind(uint8_t devAddr, bool create);
+
+        static I2Cdev_shadow_t *shadowFind(uint8_t devAddr);
+        static bool shadowRead(uint8_t devAddr, uint8_t regAddr, uint8_t length, uint8_t *data);
+        static bool shadowMatches(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t *data);
+        static void shadowUpdate(uint8_t devAddr, uint8_t regAddr, uint8_t length, const uint8_t *data);
+
+        static I2Cdev_shadow_t shadows[I2CDEV_SHADOW_MAX_DEVICES];
+        static I2Cdev_stats_t stats[I2CDEV_STATS_MAX_DEVICES];
+        static i2c_port_t busPort;
+        static i2c_config_t busConfig;
 };
 
 #endif /* _I2CDEV_H_ */
@@ -0,0 +1,196 @@
+// I2Cdev library collection - Compile-time register description
+// Typed bit fields of 8-bit device registers, on top of the I2Cdev class
+//
+// Changelog:
+//      2026-10-18 - Initial release
+
+/* ============================================
+I2Cdev device library code is placed under the MIT license
+Copyright (c) 2015 Jeff Rowberg, Nicolas Baldeck
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+===============================================
+*/
+
+#ifndef _I2CDEV_REGISTER_H_
+#define _I2CDEV_REGISTER_H_
+
+#include <stdint.h>
+#include <initializer_list>
+#include "I2Cdev.h"
+
+/*
+ * A register is a type carrying its address, a field a type carrying its
+ * register, mask and shift. Writing a set of field values:
+ *
+ *     I2CdevRegister::write(devAddr, I2CdevRegister::set<CLKSEL>(src),
+ *                                    I2CdevRegister::set<SLEEP>(false));
+ *
+ * is resolved at compile time into a single read-modify-write of the registers
+ * involved: fields of the same register are merged into one byte, consecutive
+ * registers into one burst, and the read is dropped when every bit of the
+ * burst is written. Only the field values are computed at run time.
+ */
+namespace I2CdevRegister {
+
+    /** 8-bit register at a fixed address. */
+    template <uint8_t Address>
+    struct Register {
+        static constexpr uint8_t address = Address;
+    };
+
+    /** Bit field of a register, same bitStart/length convention as I2Cdev::writeBits(). */
+    template <typename Reg, uint8_t BitStart, uint8_t Length = 1, typename T = uint8_t>
+    struct Field {
+        static_assert(Length >= 1 && BitStart < 8 && BitStart + 1 >= Length, "field does not fit in an 8-bit register");
+
+        typedef Reg reg;
+        typedef T value_type;
+
+        static constexpr uint8_t shift = BitStart - Length + 1;
+        static constexpr uint8_t mask = (uint8_t)(((1u << Length) - 1u) << shift);
+
+        static constexpr uint8_t encode(T value) { return (uint8_t)(((unsigned)value << shift) & mask); }
+        static constexpr T decode(uint8_t raw) { return (T)((raw & mask) >> shift); }
+    };
+
+    /** Single bit flag of a register. */
+    template <typename Reg, uint8_t Bit>
+    using Flag = Field<Reg, Bit, 1, bool>;
+
+    /** Value of a field, already shifted in place. */
+    template <typename F>
+    struct FieldValue {
+        uint8_t bits;
+    };
+
+    template <typename F>
+    constexpr FieldValue<F> set(typename F::value_type value) {
+        return FieldValue<F>{ F::encode(value) };
+    }
+
+    namespace detail {
+
+        constexpr uint8_t popcount(uint8_t v) {
+            return v == 0 ? 0 : (uint8_t)((v & 1) + popcount(v >> 1));
+        }
+
+        template <typename... Fs>
+        constexpr uint8_t firstAddress() {
+            uint8_t first = 0xFF;
+            for (uint8_t a : { Fs::reg::address... }) first = a < first ? a : first;
+            return first;
+        }
+
+        template <typename... Fs>
+        constexpr uint8_t lastAddress() {
+            uint8_t last = 0;
+            for (uint8_t a : { Fs::reg::address... }) last = a > last ? a : last;
+            return last;
+        }
+
+        /** Bits of register address written by the fields. */
+        template <typename... Fs>
+        constexpr uint8_t maskAt(uint8_t address) {
+            return (uint8_t)(0 | ... | (Fs::reg::address == address ? Fs::mask : 0));
+        }
+
+        /** Every register of the burst is touched and no two fields overlap. */
+        template <typename... Fs>
+        constexpr bool isValidBurst() {
+            unsigned fieldBits = (0 + ... + popcount(Fs::mask));
+            unsigned registerBits = 0;
+            for (unsigned a = firstAddress<Fs...>(); a <= lastAddress<Fs...>(); a++) {
+                if (maskAt<Fs...>(a) == 0) return false;
+                registerBits += popcount(maskAt<Fs...>(a));
+            }
+            return fieldBits == registerBits;
+        }
+
+        /** The burst has to be read first unless all of its bits are written. */
+        template <typename... Fs>
+        constexpr bool needsRead() {
+            for (unsigned a = firstAddress<Fs...>(); a <= lastAddress<Fs...>(); a++) {
+                if (maskAt<Fs...>(a) != 0xFF) return true;
+            }
+            return false;
+        }
+
+        template <typename... Fs>
+        inline uint8_t valueAt(uint8_t address, FieldValue<Fs>... values) {
+            return (uint8_t)(0 | ... | (Fs::reg::address == address ? values.bits : 0));
+        }
+    }
+
+    /** Write a set of field values in a single bus transaction.
+     * Fields may belong to one register or to consecutive registers, and must not
+     * overlap. Registers only partially written are read first (from the I2Cdev
+     * register shadow when enabled).
+     * @param devAddr I2C slave device address
+     * @param values Field values built with set<Field>()
+     * @return Status of operation (true = success)
+     */
+    template <typename... Fs>
+    bool write(uint8_t devAddr, FieldValue<Fs>... values) {
+        static_assert(sizeof...(Fs) > 0, "nothing to write");
+        static_assert(detail::isValidBurst<Fs...>(), "fields must cover consecutive registers without overlapping");
+
+        constexpr uint8_t first = detail::firstAddress<Fs...>();
+        constexpr uint8_t count = detail::lastAddress<Fs...>() - first + 1;
+        uint8_t burst[count];
+
+        if (detail::needsRead<Fs...>()) {
+            if (I2Cdev::readBytes(devAddr, first, count, burst) != count)
+                return false;
+        }
+
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t mask = detail::maskAt<Fs...>(first + i);
+            burst[i] = (uint8_t)((burst[i] & ~mask) | detail::valueAt<Fs...>(first + i, values...));
+        }
+
+        return I2Cdev::writeBytes(devAddr, first, count, burst);
+    }
+
+    /** Read a field.
+     * @param devAddr I2C slave device address
+     * @param value Container for the field value
+     * @return Status of operation (true = success, value is left unchanged otherwise)
+     */
+    template <typename F>
+    bool read(uint8_t devAddr, typename F::value_type *value) {
+        uint8_t raw;
+        if (I2Cdev::readByte(devAddr, F::reg::address, &raw) <= 0)
+            return false;
+        *value = F::decode(raw);
+        return true;
+    }
+
+    /** Read a field, returning its value (0 on bus error).
+     * @param devAddr I2C slave device address
+     */
+    template <typename F>
+    typename F::value_type get(uint8_t devAddr) {
+        typename F::value_type value = typename F::value_type();
+        read<F>(devAddr, &value);
+        return value;
+    }
+}
+
+#endif /* _I2CDEV_REGISTER_H_ */
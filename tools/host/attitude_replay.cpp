@@ -0,0 +1,255 @@
+/**
+ * @file      attitude_replay.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Host replay of the 3-D attitude (esp_mad_attitude.cpp) on simulated surface throws.
+ *
+ * @details   The samples of a MPU6050 clipped on a surface are generated at 100 Hz for several
+ *            mounting orientations : accelero = gravity in the sensor frame, gyro = hinge rate in the
+ *            sensor frame, both with noise. The same throws are replayed before the hinge axis is
+ *            learnt, after it, after a reference capture (/reset) and after a reboot with the axis
+ *            restored from NVS. The time of Attitude::update() + hingeAngle() is measured as well,
+ *            on the host CPU : the on-target figure is the "attitude" object of /runtime_stats.
+ *
+ *            Build and run from the repository root :
+ *            g++ -std=gnu++17 -O2 -Itools/host -Iextra_components/MPU6050 -Iextra_components/esp_mad_task_measure
+ *                tools/host/attitude_replay.cpp extra_components/esp_mad_task_measure/esp_mad_attitude.cpp
+ *                -o attitude_replay && ./attitude_replay
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include "esp_mad_attitude.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define SAMPLE_US       10000           /* 100 Hz, default acquisition profile          */
+#define ACCEL_LSB_G     16384.0f        /* +-2 g range                                  */
+#define ACCEL_NOISE_G   0.004f          /* MPU6050 accelero noise at 100 Hz, ~400 ug/rtHz */
+#define GYRO_NOISE_DPS  0.05f           /* MPU6050 gyro noise at 100 Hz                 */
+#define DEG             (float)(M_PI / 180.0)
+
+static std::mt19937 rng(1);
+static std::normal_distribution<float> gauss(0.0f, 1.0f);
+
+typedef struct {
+	const char *name;
+	Quaternion mount;                   /* sensor to earth at rest                      */
+	VectorFloat hinge;                  /* hinge axis, earth frame                      */
+} mounting_t;
+
+/*--- Sensor state along the replay ---*/
+static Quaternion mount;
+static VectorFloat hingeEarth;
+static float theta = 0.0f;              /* surface angle about the hinge, degree        */
+static Quaternion extra;                /* rotation not about the hinge (earth frame)   */
+static int64_t now = 0;
+
+/**
+ *	@fn 		static Quaternion axis_angle(VectorFloat axis, float degree)
+ *  @brief		Rotation of degree about axis
+ *
+ */
+static Quaternion axis_angle(VectorFloat axis, float degree)
+{
+	axis.normalize();
+	float h = 0.5f * degree * DEG;
+	return Quaternion(cosf(h), axis.x * sinf(h), axis.y * sinf(h), axis.z * sinf(h));
+}
+
+/**
+ *	@fn 		static attitude_sample_t sample(float rateDps, VectorFloat rateAxis)
+ *  @brief		Next sample of the sensor, rotating at rateDps about rateAxis (earth frame)
+ *
+ */
+static attitude_sample_t sample(float rateDps, VectorFloat rateAxis)
+{
+	Quaternion q = extra.getProduct(axis_angle(hingeEarth, theta)).getProduct(mount);
+	Quaternion toSensor = q.getConjugate();
+	VectorFloat g(0.0f, 0.0f, 1.0f);
+	VectorFloat w(rateAxis.x * rateDps, rateAxis.y * rateDps, rateAxis.z * rateDps);
+
+	g.rotate(&toSensor);
+	w.rotate(&toSensor);
+	now += SAMPLE_US;
+
+	attitude_sample_t s;
+	s.timestamp = now;
+	s.ax = (int16_t)lrintf((g.x + ACCEL_NOISE_G * gauss(rng)) * ACCEL_LSB_G);
+	s.ay = (int16_t)lrintf((g.y + ACCEL_NOISE_G * gauss(rng)) * ACCEL_LSB_G);
+	s.az = (int16_t)lrintf((g.z + ACCEL_NOISE_G * gauss(rng)) * ACCEL_LSB_G);
+	s.gx = w.x + GYRO_NOISE_DPS * gauss(rng);
+	s.gy = w.y + GYRO_NOISE_DPS * gauss(rng);
+	s.gz = w.z + GYRO_NOISE_DPS * gauss(rng);
+	s.accelValid = true;
+	return s;
+}
+
+/**
+ *	@fn 		static float hold(Attitude &a, float seconds)
+ *  @brief		Surface still, mean angle over the second half of the hold
+ *
+ */
+static float hold(Attitude &a, float seconds)
+{
+	int n = (int)(seconds * 1e6f / SAMPLE_US);
+	float sum = 0.0f;
+
+	for(int i = 0; i < n; i++){
+		a.update(sample(0.0f, hingeEarth));
+		if(i >= n / 2)
+			sum += a.hingeAngle();
+	}
+	return sum / (n - n / 2);
+}
+
+/**
+ *	@fn 		static float throw_to(Attitude &a, float target)
+ *  @brief		Surface moved to target degree about the hinge in 0.3 s, then held 1 s
+ *
+ */
+static float throw_to(Attitude &a, float target)
+{
+	int n = 300000 / SAMPLE_US;
+	float rate = (target - theta) / 0.3f;
+
+	for(int i = 0; i < n; i++){
+		theta += rate * SAMPLE_US * 1e-6f;
+		a.update(sample(rate, hingeEarth));
+	}
+	theta = target;
+	return hold(a, 1.0f);
+}
+
+/**
+ *	@fn 		static void throws(Attitude &a, const float *targets, int count)
+ *  @brief		Series of throws, printed as target -> angle read, then whether the axis is learnt
+ *
+ */
+static void throws(Attitude &a, const float *targets, int count)
+{
+	for(int i = 0; i < count; i++){
+		float angle = throw_to(a, targets[i]);
+		printf("  %+5.1f -> %+6.2f", targets[i], angle);
+	}
+	printf("  (hinge learnt %d)\n", a.hingeLearnt());
+}
+
+/**
+ *	@fn 		static float twist_off_axis(Attitude &a, VectorFloat axis, float degree)
+ *  @brief		Sensor rotated about an axis orthogonal to the hinge (clip flexing), then held
+ *
+ */
+static float twist_off_axis(Attitude &a, VectorFloat axis, float degree)
+{
+	int n = 300000 / SAMPLE_US;
+	float rate = degree / 0.3f;
+
+	for(int i = 0; i < n; i++){
+		extra = axis_angle(axis, rate * (i + 1) * SAMPLE_US * 1e-6f);
+		a.update(sample(rate, axis));
+	}
+	float angle = hold(a, 1.0f);
+	extra = Quaternion();
+	return angle;
+}
+
+/**
+ *	@fn 		static void replay(const mounting_t &m)
+ *  @brief		Throws before / after learning, after /reset and after a reboot
+ *
+ */
+static void replay(const mounting_t &m)
+{
+	Attitude a;
+
+	mount = m.mount;
+	hingeEarth = m.hinge;
+	theta = 0.0f;
+	extra = Quaternion();
+
+	printf("\n%s\n", m.name);
+	hold(a, 2.0f);
+	printf("  hinge unknown :");
+	throws(a, (const float[]){8.0f, -5.0f, 2.0f}, 3);
+	printf("  learning      :");
+	throws(a, (const float[]){12.0f, 8.0f, -3.0f}, 3);
+	VectorFloat axis = a.hingeAxis();
+	printf("  hinge axis    : %.3f %.3f %.3f\n", axis.x, axis.y, axis.z);
+
+	/*--- /reset at 0 : the hinge is kept ---*/
+	throw_to(a, 0.0f);
+	a.captureReference();
+	printf("  after /reset  :");
+	throws(a, (const float[]){8.0f, -2.0f}, 2);
+
+	/*--- 8 degree about an axis orthogonal to the hinge : not a surface travel ---*/
+	VectorFloat ortho(m.hinge.y, -m.hinge.x, 0.0f);
+	if(ortho.getMagnitude() < 0.1f)
+		ortho = VectorFloat(1.0f, 0.0f, 0.0f);
+	throw_to(a, 0.0f);
+	printf("  off-axis 8    : %6.2f\n", twist_off_axis(a, ortho, 8.0f));
+
+	/*--- Reboot : axis restored from NVS, reference at power-on ---*/
+	Attitude b;
+	theta = 0.0f;
+	b.setHinge(axis);
+	hold(b, 2.0f);
+	printf("  after reboot  :");
+	throws(b, (const float[]){8.0f, -0.5f, 0.2f}, 3);
+}
+
+/**
+ *	@fn 		static void timing(void)
+ *  @brief		Time of one update + hingeAngle() on the host CPU
+ *
+ */
+static void timing(void)
+{
+	const int n = 200000;
+	static attitude_sample_t samples[1000];
+	Attitude a;
+	volatile float sink = 0.0f;
+
+	mount = Quaternion();
+	hingeEarth = VectorFloat(0.0f, -1.0f, 0.0f);
+	for(int i = 0; i < 1000; i++){
+		theta = 20.0f * sinf(i * 0.02f);
+		samples[i] = sample(20.0f * 0.02f * 100.0f * cosf(i * 0.02f), hingeEarth);
+	}
+
+	int64_t t0 = samples[0].timestamp;
+	auto start = std::chrono::steady_clock::now();
+	for(int i = 0; i < n; i++){
+		attitude_sample_t s = samples[i % 1000];
+		s.timestamp = t0 + (int64_t)i * SAMPLE_US;
+		a.update(s);
+		sink = sink + a.hingeAngle();
+	}
+	auto stop = std::chrono::steady_clock::now();
+	double ns = std::chrono::duration<double, std::nano>(stop - start).count() / n;
+
+	printf("\nupdate + hingeAngle : %.0f ns per sample on the host (budget at 100 Hz : 10 ms)\n", ns);
+}
+
+int main(void)
+{
+	static const mounting_t mountings[] = {
+		{"historical mounting, hinge along -Y", Quaternion(), VectorFloat(0.0f, -1.0f, 0.0f)},
+		{"sideways, hinge along sensor X", axis_angle(VectorFloat(0.0f, 0.0f, 1.0f), 90.0f), VectorFloat(0.0f, 1.0f, 0.0f)},
+		{"V-tail, sensor rolled 35 deg and yawed 20 deg", axis_angle(VectorFloat(0.0f, 0.0f, 1.0f), 20.0f).getProduct(axis_angle(VectorFloat(1.0f, 0.0f, 0.0f), 35.0f)),
+		 VectorFloat(cosf(20.0f * DEG), sinf(20.0f * DEG), 0.0f)},
+	};
+
+	for(const mounting_t &m : mountings)
+		replay(m);
+	timing();
+	return 0;
+}
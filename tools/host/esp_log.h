@@ -0,0 +1,23 @@
+/**
+ * @file      esp_log.h
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Host stand-in of the ESP-IDF log macros, for the replay programs of tools/host.
+ *
+ * @details   Only what the measure modules compiled on the host use. Nothing of it is built in
+ *            the firmwares.
+ *
+ */
+
+#ifndef _HOST_ESP_LOG_H_
+
+#define _HOST_ESP_LOG_H_
+
+#include <stdio.h>
+
+#define ESP_LOGE(tag, format, ...)  printf("E %s" format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  printf("W %s" format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  printf("I %s" format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  do {} while(0)
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file      fft_check.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Host check of the fixed-point FFT (esp_mad_fft.cpp) against a reference DFT.
+ *
+ * @details   The jitter analysis input is built as on the target : int16 gyro samples, mean removed,
+ *            Hann windowed in Q15 and shifted left by 7. fft_q15() is compared bin by bin with a double
+ *            precision DFT of the same input scaled by 1 / size, for a full scale sine between two
+ *            bins, two sines 60 dB apart and white noise. The error is printed relative to the largest
+ *            reference bin, with the level of the weak sine seen by both. The time of one fft_q15() and
+ *            of one reference DFT is measured as well, on the host CPU.
+ *
+ *            Build and run from the repository root :
+ *            g++ -std=gnu++17 -O2 -Iextra_components/esp_mad_task_measure tools/host/fft_check.cpp
+ *                extra_components/esp_mad_task_measure/esp_mad_fft.cpp -o fft_check && ./fft_check
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include "esp_mad_fft.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define FFT_SIZE        256             /* JITTER_FFT_SIZE                              */
+#define INPUT_SHIFT     7               /* JITTER_INPUT_SHIFT                           */
+
+static int16_t cosTable[FFT_SIZE / 2];
+static int16_t sinTable[FFT_SIZE / 2];
+static int16_t hann[FFT_SIZE];
+
+/**
+ *	@fn 		static void prepare(const int16_t *block, int32_t *re, int32_t *im)
+ *  @brief		Mean removed, Hann window, shift : the input of fft_q15() in esp_mad_jitter.cpp
+ *
+ */
+static void prepare(const int16_t *block, int32_t *re, int32_t *im)
+{
+	int32_t mean = 0;
+
+	for(int i = 0; i < FFT_SIZE; i++)
+		mean += block[i];
+	mean /= FFT_SIZE;
+	for(int i = 0; i < FFT_SIZE; i++){
+		int32_t x = block[i] - mean;
+		x = x > INT16_MAX ? INT16_MAX : x < INT16_MIN ? INT16_MIN : x;
+		re[i] = ((x * hann[i]) >> 15) << INPUT_SHIFT;
+		im[i] = 0;
+	}
+}
+
+/**
+ *	@fn 		static void dft(const int32_t *x, double *re, double *im)
+ *  @brief		Reference DFT of a real input, scaled by 1 / size like fft_q15()
+ *
+ */
+static void dft(const int32_t *x, double *re, double *im)
+{
+	for(int k = 0; k < FFT_SIZE; k++){
+		double sr = 0.0, si = 0.0;
+		for(int n = 0; n < FFT_SIZE; n++){
+			double a = 2.0 * M_PI * (double)((k * n) % FFT_SIZE) / FFT_SIZE;
+			sr += x[n] * cos(a);
+			si -= x[n] * sin(a);
+		}
+		re[k] = sr / FFT_SIZE;
+		im[k] = si / FFT_SIZE;
+	}
+}
+
+/**
+ *	@fn 		static void check(const char *name, const int16_t *block, int weakBin)
+ *  @brief		Bin by bin error of fft_q15() against the DFT, in dB below the largest bin
+ *
+ */
+static void check(const char *name, const int16_t *block, int weakBin)
+{
+	int32_t input[FFT_SIZE], re[FFT_SIZE], im[FFT_SIZE];
+	double rr[FFT_SIZE], ri[FFT_SIZE];
+
+	prepare(block, input, im);
+	for(int i = 0; i < FFT_SIZE; i++)
+		re[i] = input[i];
+	fft_q15(re, im, FFT_SIZE, cosTable, sinTable);
+	dft(input, rr, ri);
+
+	double peak = 0.0, maxErr = 0.0, sumErr2 = 0.0;
+	for(int k = 0; k < FFT_SIZE; k++){
+		peak = fmax(peak, hypot(rr[k], ri[k]));
+		double e = hypot(re[k] - rr[k], im[k] - ri[k]);
+		maxErr = fmax(maxErr, e);
+		sumErr2 += e * e;
+	}
+	double rmsErr = sqrt(sumErr2 / FFT_SIZE);
+
+	printf("%-18s max error %6.1f dB, rms error %6.1f dB", name, 20.0 * log10(maxErr / peak), 20.0 * log10(rmsErr / peak));
+	if(weakBin > 0)
+		printf(", bin %d : %6.1f dB (DFT %6.1f dB)", weakBin, 20.0 * log10(hypot(re[weakBin], im[weakBin]) / peak),
+			   20.0 * log10(hypot(rr[weakBin], ri[weakBin]) / peak));
+	printf("\n");
+}
+
+/**
+ *	@fn 		static void timing(const int16_t *block)
+ *  @brief		Time of one fft_q15() and of one reference DFT on the host CPU
+ *
+ */
+static void timing(const int16_t *block)
+{
+	const int rounds = 20000;
+	int32_t input[FFT_SIZE], re[FFT_SIZE], im[FFT_SIZE];
+	double rr[FFT_SIZE], ri[FFT_SIZE];
+	volatile int32_t sink = 0;
+
+	prepare(block, input, im);
+	auto start = std::chrono::steady_clock::now();
+	for(int r = 0; r < rounds; r++){
+		for(int i = 0; i < FFT_SIZE; i++){
+			re[i] = input[i];
+			im[i] = 0;
+		}
+		fft_q15(re, im, FFT_SIZE, cosTable, sinTable);
+		sink = sink + re[r % FFT_SIZE];
+	}
+	auto stop = std::chrono::steady_clock::now();
+	double fftUs = std::chrono::duration<double, std::micro>(stop - start).count() / rounds;
+
+	start = std::chrono::steady_clock::now();
+	for(int r = 0; r < 20; r++)
+		dft(input, rr, ri);
+	stop = std::chrono::steady_clock::now();
+	double dftUs = std::chrono::duration<double, std::micro>(stop - start).count() / 20;
+
+	printf("\n%d points on the host : fft_q15 %.2f us, reference DFT %.0f us (block period at 1 kHz : %d ms)\n",
+		   FFT_SIZE, fftUs, dftUs, FFT_SIZE);
+}
+
+int main(void)
+{
+	static int16_t block[FFT_SIZE];
+	std::mt19937 rng(1);
+	std::normal_distribution<double> gauss(0.0, 1.0);
+
+	fft_q15_twiddles(cosTable, sinTable, FFT_SIZE);
+	for(int i = 0; i < FFT_SIZE; i++)
+		hann[i] = (int16_t)lrintf((0.5f - 0.5f * cosf(2.0f * (float)M_PI * i / FFT_SIZE)) * 32767.0f);
+
+	/*--- Full scale sine between bins 20 and 21 (80 Hz at 1 kHz) ---*/
+	for(int i = 0; i < FFT_SIZE; i++)
+		block[i] = (int16_t)lrint(32000.0 * sin(2.0 * M_PI * 20.5 * i / FFT_SIZE));
+	check("full scale sine", block, 0);
+
+	/*--- Strong servo motion and a weak buzz 60 dB below ---*/
+	for(int i = 0; i < FFT_SIZE; i++)
+		block[i] = (int16_t)lrint(30000.0 * sin(2.0 * M_PI * 3.0 * i / FFT_SIZE) + 30.0 * sin(2.0 * M_PI * 64.0 * i / FFT_SIZE));
+	check("sine + 60 dB sine", block, 64);
+
+	/*--- Gyro noise, 500 LSB rms ---*/
+	for(int i = 0; i < FFT_SIZE; i++)
+		block[i] = (int16_t)lrint(500.0 * gauss(rng));
+	check("white noise", block, 0);
+
+	timing(block);
+	return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file      fusion_replay.cpp
+ * @author    Alain Désandré - alain.desandre@wanadoo.fr
+ * @date      October 18th 2026
+ * @brief     Host replay of the single axis fusion filters (esp_mad_fusion.h) on simulated surface moves.
+ *
+ * @details   The samples of a MPU6050 on a control surface are generated at 100 Hz : accelero = gravity
+ *            at the surface angle, gyro = angle rate, both with the MPU6050 noise. The same samples go
+ *            through the complementary, Mahony and Kalman policies, and the angle error against the
+ *            true angle is printed for each scenario :
+ *              - still      : surface held at 5 deg, 30 s
+ *              - throws     : 10 deg moves in 0.1 s (a servo), error 0.5 s to 1.5 s after the move
+ *              - bias       : 0.3 deg/s residual gyro bias (warm-up drift), surface held 60 s
+ *              - vibration  : 0.05 g accelero noise (motor running), surface held 30 s
+ *              - gated      : 20 % of the samples rejected by the prefilter, surface moving slowly
+ *            The time of one update is measured as well, on the host CPU.
+ *
+ *            Build and run from the repository root :
+ *            g++ -std=gnu++17 -O2 -Iextra_components/esp_mad_task_measure tools/host/fusion_replay.cpp
+ *                -o fusion_replay && ./fusion_replay
+ *
+ */
+
+/*-----------------------------------------
+ *-            INCLUDES
+ *-----------------------------------------*/
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "esp_mad_fusion.h"
+
+/*-----------------------------------------
+ *-            LOCALS VARIABLES
+ *-----------------------------------------*/
+#define SAMPLE_US       10000           /* 100 Hz, default acquisition profile          */
+#define ACCEL_LSB_G     16384.0f        /* +-2 g range                                  */
+#define ACCEL_NOISE_G   0.004f          /* MPU6050 accelero noise at 100 Hz             */
+#define GYRO_NOISE_DPS  0.05f           /* MPU6050 gyro noise at 100 Hz                 */
+#define DEG             (float)(M_PI / 180.0)
+
+typedef struct {
+	fusion_sample_t sample;
+	float truth;                        /* true surface angle, degree                   */
+	bool scored;                        /* sample counted in the error                  */
+} replay_sample_t;
+
+typedef struct {
+	double rms;
+	double maxAbs;
+	double mean;
+} replay_error_t;
+
+/**
+ *	@fn 		class Generator
+ *  @brief		Samples of a surface following a trajectory, with the sensor noise
+ *
+ */
+class Generator {
+	std::mt19937 rng;
+	std::normal_distribution<float> gauss{0.0f, 1.0f};
+	std::uniform_real_distribution<float> uniform{0.0f, 1.0f};
+	int64_t now = 0;
+
+public:
+	float accelNoise = ACCEL_NOISE_G;
+	float gyroBias = 0.0f;
+	float gatedRatio = 0.0f;
+	std::vector<replay_sample_t> samples;
+
+	explicit Generator(unsigned seed) : rng(seed) {}
+
+	void add(float angle, float rate, bool scored){
+		replay_sample_t r;
+		now += SAMPLE_US;
+		r.sample.timestamp = now;
+		r.sample.ax = (int16_t)lrintf((sinf(angle * DEG) + accelNoise * gauss(rng)) * ACCEL_LSB_G);
+		r.sample.ay = 0;
+		r.sample.az = (int16_t)lrintf((cosf(angle * DEG) + accelNoise * gauss(rng)) * ACCEL_LSB_G);
+		r.sample.rate = rate + gyroBias + GYRO_NOISE_DPS * gauss(rng);
+		r.sample.accelValid = uniform(rng) >= gatedRatio;
+		r.truth = angle;
+		r.scored = scored;
+		samples.push_back(r);
+	}
+
+	void hold(float angle, float seconds, bool scored){
+		int n = (int)(seconds * 1e6f / SAMPLE_US);
+		for(int i = 0; i < n; i++)
+			add(angle, 0.0f, scored);
+	}
+
+	void move(float from, float to, float seconds){
+		int n = (int)(seconds * 1e6f / SAMPLE_US);
+		float rate = (to - from) / seconds;
+		for(int i = 1; i <= n; i++)
+			add(from + (to - from) * i / n, rate, false);
+	}
+};
+
+/**
+ *	@fn 		template <class Policy> static replay_error_t replay(const std::vector<replay_sample_t> &samples)
+ *  @brief		Angle error of a policy over the scored samples
+ *
+ */
+template <class Policy>
+static replay_error_t replay(const std::vector<replay_sample_t> &samples)
+{
+	FusionFilter<Policy> filter;
+	double sum = 0.0, sum2 = 0.0, maxAbs = 0.0;
+	int n = 0;
+
+	for(const replay_sample_t &r : samples){
+		float e = filter.update(r.sample) - r.truth;
+		if(!r.scored)
+			continue;
+		sum += e;
+		sum2 += (double)e * e;
+		maxAbs = fabs(e) > maxAbs ? fabs(e) : maxAbs;
+		n++;
+	}
+	return {sqrt(sum2 / n), maxAbs, sum / n};
+}
+
+/**
+ *	@fn 		static void scenario(const char *name, const Generator &g)
+ *  @brief		One line per policy : rms, max and mean error in degree
+ *
+ */
+static void scenario(const char *name, const Generator &g)
+{
+	replay_error_t c = replay<ComplementaryPolicy>(g.samples);
+	replay_error_t m = replay<MahonyPolicy>(g.samples);
+	replay_error_t k = replay<KalmanPolicy>(g.samples);
+
+	printf("%-10s %6.3f %6.3f %+6.3f | %6.3f %6.3f %+6.3f | %6.3f %6.3f %+6.3f\n", name,
+		   c.rms, c.maxAbs, c.mean, m.rms, m.maxAbs, m.mean, k.rms, k.maxAbs, k.mean);
+}
+
+/**
+ *	@fn 		template <class Policy> static double timing(const std::vector<replay_sample_t> &samples)
+ *  @brief		Time of one update on the host CPU, in ns
+ *
+ */
+template <class Policy>
+static double timing(const std::vector<replay_sample_t> &samples)
+{
+	const int rounds = 200;
+	FusionFilter<Policy> filter;
+	volatile float sink = 0.0f;
+	int64_t span = samples.back().sample.timestamp;
+
+	auto start = std::chrono::steady_clock::now();
+	for(int r = 0; r < rounds; r++){
+		for(const replay_sample_t &s : samples){
+			fusion_sample_t sample = s.sample;
+			sample.timestamp += r * span;
+			sink = sink + filter.update(sample);
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(stop - start).count() / ((double)rounds * samples.size());
+}
+
+int main(void)
+{
+	printf("error in degree    complementary       |       Mahony          |       Kalman\n");
+	printf("%-10s %6s %6s %6s | %6s %6s %6s | %6s %6s %6s\n", "", "rms", "max", "mean", "rms", "max", "mean", "rms", "max", "mean");
+
+	Generator still(1);
+	still.hold(5.0f, 2.0f, false);
+	still.hold(5.0f, 30.0f, true);
+	scenario("still", still);
+
+	Generator throws(2);
+	static const float targets[] = {10.0f, -10.0f, 0.0f, 20.0f, 10.0f, -5.0f};
+	float angle = 0.0f;
+	throws.hold(0.0f, 2.0f, false);
+	for(float target : targets){
+		throws.move(angle, target, 0.1f);
+		throws.hold(target, 0.5f, false);
+		throws.hold(target, 1.0f, true);
+		angle = target;
+	}
+	scenario("throws", throws);
+
+	Generator bias(3);
+	bias.gyroBias = 0.3f;
+	bias.hold(5.0f, 2.0f, false);
+	bias.hold(5.0f, 60.0f, true);
+	scenario("bias", bias);
+
+	Generator vibration(4);
+	vibration.accelNoise = 0.05f;
+	vibration.hold(5.0f, 2.0f, false);
+	vibration.hold(5.0f, 30.0f, true);
+	scenario("vibration", vibration);
+
+	Generator gated(5);
+	gated.gatedRatio = 0.2f;
+	angle = 0.0f;
+	gated.hold(0.0f, 2.0f, false);
+	for(int i = 0; i < 20; i++){
+		float target = (i % 2) ? -8.0f : 8.0f;
+		gated.move(angle, target, 1.0f);
+		gated.hold(target, 1.0f, true);
+		angle = target;
+	}
+	scenario("gated", gated);
+
+	printf("\nupdate time on the host : complementary %.1f ns, Mahony %.1f ns, Kalman %.1f ns\n",
+		   timing<ComplementaryPolicy>(throws.samples), timing<MahonyPolicy>(throws.samples),
+		   timing<KalmanPolicy>(throws.samples));
+	return 0;
+}